@@ -0,0 +1,1969 @@
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#include "bcn.h"
+#include "thread_pool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BCN_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace bcn
+{
+    namespace
+    {
+        // Colors of a BC1 color block as RGBA. bc1 allows the 3 color mode with transparent black that only BC1
+        // has; the color blocks of BC2 and BC3 always interpolate 4 colors.
+        inline void colorPalette(const uint8_t* block, bool bc1, uint8_t pal[4][4])
+        {
+            const unsigned c0 = block[0] | (block[1] << 8);
+            const unsigned c1 = block[2] | (block[3] << 8);
+            // 565 to 888, the top bits repeated in the bottom ones so that 31 and 63 become 255
+            int r0 = (c0 >> 11) & 31, g0 = (c0 >> 5) & 63, b0 = c0 & 31;
+            int r1 = (c1 >> 11) & 31, g1 = (c1 >> 5) & 63, b1 = c1 & 31;
+            r0 = (r0 << 3) | (r0 >> 2); g0 = (g0 << 2) | (g0 >> 4); b0 = (b0 << 3) | (b0 >> 2);
+            r1 = (r1 << 3) | (r1 >> 2); g1 = (g1 << 2) | (g1 >> 4); b1 = (b1 << 3) | (b1 >> 2);
+
+            pal[0][0] = (uint8_t)r0; pal[0][1] = (uint8_t)g0; pal[0][2] = (uint8_t)b0; pal[0][3] = 255;
+            pal[1][0] = (uint8_t)r1; pal[1][1] = (uint8_t)g1; pal[1][2] = (uint8_t)b1; pal[1][3] = 255;
+            if (c0 > c1 || !bc1)
+            {
+                pal[2][0] = (uint8_t)((2 * r0 + r1 + 1) / 3);
+                pal[2][1] = (uint8_t)((2 * g0 + g1 + 1) / 3);
+                pal[2][2] = (uint8_t)((2 * b0 + b1 + 1) / 3);
+                pal[2][3] = 255;
+                pal[3][0] = (uint8_t)((r0 + 2 * r1 + 1) / 3);
+                pal[3][1] = (uint8_t)((g0 + 2 * g1 + 1) / 3);
+                pal[3][2] = (uint8_t)((b0 + 2 * b1 + 1) / 3);
+                pal[3][3] = 255;
+            }
+            else
+            {
+                pal[2][0] = (uint8_t)((r0 + r1 + 1) / 2);
+                pal[2][1] = (uint8_t)((g0 + g1 + 1) / 2);
+                pal[2][2] = (uint8_t)((b0 + b1 + 1) / 2);
+                pal[2][3] = 255;
+                memset(pal[3], 0, 4);
+            }
+        }
+
+        // Writes the 4x4 pixels of a color block as RGBA, rows stride bytes apart. Every pixel is a copy of one of
+        // the 4 palette entries, picked by its 2-bit index: no branches, one 32-bit store per pixel.
+        inline void decodeColor(const uint8_t* block, bool bc1, uint8_t* dst, size_t stride)
+        {
+            uint8_t pal[4][4];
+            colorPalette(block, bc1, pal);
+            for (int y = 0; y < 4; ++y)
+            {
+                const unsigned bits = block[4 + y];
+                uint8_t* row = dst + y * stride;
+                memcpy(row + 0, pal[bits & 3], 4);
+                memcpy(row + 4, pal[(bits >> 2) & 3], 4);
+                memcpy(row + 8, pal[(bits >> 4) & 3], 4);
+                memcpy(row + 12, pal[(bits >> 6) & 3], 4);
+            }
+        }
+
+        // Values of a BC4 block, which is also the alpha of BC3: 2 endpoints and 6 values between them, or 4 values
+        // between them and the ends of the range. SNORM endpoints are moved up by 127 to 0 to 254, and each value is
+        // stretched to 0 to 255 in the same division that ends its interpolation, so it is only rounded once.
+        inline void channelPalette(const uint8_t* block, bool isSigned, uint8_t pal[8])
+        {
+            int a0, a1, top;
+            if (isSigned)
+            {
+                // -128 is read as -127, both are -1.0
+                a0 = std::max((int)(int8_t)block[0], -127) + 127;
+                a1 = std::max((int)(int8_t)block[1], -127) + 127;
+                top = 254;
+            }
+            else
+            {
+                a0 = block[0];
+                a1 = block[1];
+                top = 255;
+            }
+
+            // value i is num[i] / steps, scaled by 255 / top
+            int num[8], steps;
+            if (a0 > a1)
+            {
+                steps = 7;
+                for (int i = 1; i < 7; ++i)
+                    num[i + 1] = (7 - i) * a0 + i * a1;
+            }
+            else
+            {
+                steps = 5;
+                for (int i = 1; i < 5; ++i)
+                    num[i + 1] = (5 - i) * a0 + i * a1;
+                num[6] = 0;
+                num[7] = top * steps;
+            }
+            num[0] = a0 * steps;
+            num[1] = a1 * steps;
+            const int den = steps * top;
+            for (int i = 0; i < 8; ++i)
+                pal[i] = (uint8_t)((num[i] * 255 + den / 2) / den);
+        }
+
+        // Writes the 16 values of a BC4 block every step bytes, rows stride bytes apart.
+        inline void decodeChannel(const uint8_t* block, bool isSigned, uint8_t* dst, size_t stride, int step)
+        {
+            uint8_t pal[8];
+            channelPalette(block, isSigned, pal);
+            // 16 indices of 3 bits, little endian in bytes 2 to 7
+            uint64_t bits = 0;
+            for (int i = 7; i >= 2; --i)
+                bits = (bits << 8) | block[i];
+            for (int y = 0; y < 4; ++y)
+            {
+                uint8_t* row = dst + y * stride;
+                row[0] = pal[bits & 7];
+                row[step] = pal[(bits >> 3) & 7];
+                row[2 * step] = pal[(bits >> 6) & 7];
+                row[3 * step] = pal[(bits >> 9) & 7];
+                bits >>= 12;
+            }
+        }
+
+        // Writes the 4-bit alphas of a BC2 block into every 4th byte from dst.
+        inline void decodeExplicitAlpha(const uint8_t* block, uint8_t* dst, size_t stride)
+        {
+            for (int y = 0; y < 4; ++y)
+            {
+                const unsigned bits = block[2 * y] | (block[2 * y + 1] << 8);
+                uint8_t* row = dst + y * stride;
+                row[0] = (uint8_t)((bits & 15) * 17);
+                row[4] = (uint8_t)(((bits >> 4) & 15) * 17);
+                row[8] = (uint8_t)(((bits >> 8) & 15) * 17);
+                row[12] = (uint8_t)((bits >> 12) * 17);
+            }
+        }
+
+        void decodeBC1(const uint8_t* block, uint8_t* dst, size_t stride)
+        {
+            decodeColor(block, true, dst, stride);
+        }
+
+        void decodeBC2(const uint8_t* block, uint8_t* dst, size_t stride)
+        {
+            decodeColor(block + 8, false, dst, stride);
+            decodeExplicitAlpha(block, dst + 3, stride);
+        }
+
+        void decodeBC3(const uint8_t* block, uint8_t* dst, size_t stride)
+        {
+            decodeColor(block + 8, false, dst, stride);
+            decodeChannel(block, false, dst + 3, stride, 4);
+        }
+
+        template <bool isSigned>
+        void decodeBC4(const uint8_t* block, uint8_t* dst, size_t stride)
+        {
+            decodeChannel(block, isSigned, dst, stride, 1);
+        }
+
+        template <bool isSigned>
+        void decodeBC5(const uint8_t* block, uint8_t* dst, size_t stride)
+        {
+            decodeChannel(block, isSigned, dst, stride, 3);
+            decodeChannel(block + 8, isSigned, dst + 1, stride, 3);
+            for (int y = 0; y < 4; ++y)
+            {
+                uint8_t* row = dst + y * stride;
+                row[2] = row[5] = row[8] = row[11] = 0;
+            }
+        }
+
+        // BC6H and BC7 (BPTC) blocks are 128-bit fields read from the least significant bit up.
+        struct BlockBits
+        {
+            uint64_t lo, hi;
+
+            explicit BlockBits(const uint8_t* block)
+            {
+                lo = hi = 0;
+                for (int i = 7; i >= 0; --i)
+                {
+                    lo = (lo << 8) | block[i];
+                    hi = (hi << 8) | block[i + 8];
+                }
+            }
+
+            inline unsigned read(int n)
+            {
+                if (n == 0)
+                    return 0;
+                const unsigned v = (unsigned)(lo & ((1ull << n) - 1));
+                lo = (lo >> n) | (hi << (64 - n));
+                hi >>= n;
+                return v;
+            }
+        };
+
+        // Subset of each pixel in the 2 subset partitions, bit i for pixel i. BC6H uses the first 32.
+        const uint16_t partitions2[64] = {
+            0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80, 0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+            0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE, 0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+            0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A, 0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+            0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C, 0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22
+        };
+
+        // Subset of each pixel in the 3 subset partitions.
+        const uint8_t partitions3[64][16] = {
+            { 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 1, 2, 2, 2, 2 }, { 0, 0, 0, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 2, 1 },
+            { 0, 0, 0, 0, 2, 0, 0, 1, 2, 2, 1, 1, 2, 2, 1, 1 }, { 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 1, 0, 1, 1, 1 },
+            { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2 }, { 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 2, 2 },
+            { 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1 }, { 0, 0, 1, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1 },
+            { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2 }, { 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2 },
+            { 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2 }, { 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2 },
+            { 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2 }, { 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2 },
+            { 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2, 1, 2, 2, 2 }, { 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0, 2, 2, 2, 0 },
+            { 0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2 }, { 0, 1, 1, 1, 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0 },
+            { 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2 }, { 0, 0, 2, 2, 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1 },
+            { 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2, 0, 2, 2, 2 }, { 0, 0, 0, 1, 0, 0, 0, 1, 2, 2, 2, 1, 2, 2, 2, 1 },
+            { 0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2 }, { 0, 0, 0, 0, 1, 1, 0, 0, 2, 2, 1, 0, 2, 2, 1, 0 },
+            { 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1, 0, 0, 0, 0 }, { 0, 0, 1, 2, 0, 0, 1, 2, 1, 1, 2, 2, 2, 2, 2, 2 },
+            { 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1, 0, 1, 1, 0 }, { 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1 },
+            { 0, 0, 2, 2, 1, 1, 0, 2, 1, 1, 0, 2, 0, 0, 2, 2 }, { 0, 1, 1, 0, 0, 1, 1, 0, 2, 0, 0, 2, 2, 2, 2, 2 },
+            { 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1 }, { 0, 0, 0, 0, 2, 0, 0, 0, 2, 2, 1, 1, 2, 2, 2, 1 },
+            { 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 2, 2, 2 }, { 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 2, 0, 0, 1, 1 },
+            { 0, 0, 1, 1, 0, 0, 1, 2, 0, 0, 2, 2, 0, 2, 2, 2 }, { 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0 },
+            { 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0 }, { 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0 },
+            { 0, 1, 2, 0, 2, 0, 1, 2, 1, 2, 0, 1, 0, 1, 2, 0 }, { 0, 0, 1, 1, 2, 2, 0, 0, 1, 1, 2, 2, 0, 0, 1, 1 },
+            { 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0, 1, 1 }, { 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2 },
+            { 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1 }, { 0, 0, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2, 1, 1, 2, 2 },
+            { 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 1, 1 }, { 0, 2, 2, 0, 1, 2, 2, 1, 0, 2, 2, 0, 1, 2, 2, 1 },
+            { 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 0, 1, 0, 1 }, { 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1 },
+            { 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2 }, { 0, 2, 2, 2, 0, 1, 1, 1, 0, 2, 2, 2, 0, 1, 1, 1 },
+            { 0, 0, 0, 2, 1, 1, 1, 2, 0, 0, 0, 2, 1, 1, 1, 2 }, { 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2 },
+            { 0, 2, 2, 2, 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2 }, { 0, 0, 0, 2, 1, 1, 1, 2, 1, 1, 1, 2, 0, 0, 0, 2 },
+            { 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2 }, { 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2 },
+            { 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2, 2, 2, 2, 2 }, { 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2 },
+            { 0, 0, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2 },
+            { 0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 1 }, { 0, 2, 2, 2, 1, 2, 2, 2, 0, 2, 2, 2, 1, 2, 2, 2 },
+            { 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2 }, { 0, 1, 1, 1, 2, 0, 1, 1, 2, 2, 0, 1, 2, 2, 2, 0 }
+        };
+
+        // Pixel whose index has one bit less, as its top bit is always 0, for the second subset of the 2 subset
+        // partitions, and the second and third subsets of the 3 subset partitions. The first subset's is pixel 0.
+        const uint8_t anchors2[64] = {
+            15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+            15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+            15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+             6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15
+        };
+        const uint8_t anchors3a[64] = {
+             3,  3, 15, 15,  8,  3, 15, 15,  8,  8,  6,  6,  6,  5,  3,  3,
+             3,  3,  8, 15,  3,  3,  6, 10,  5,  8,  8,  6,  8,  5, 15, 15,
+             8, 15,  3,  5,  6, 10,  8, 15, 15,  3, 15,  5, 15, 15, 15, 15,
+             3, 15,  5,  5,  5,  8,  5, 10,  5, 10,  8, 13, 15, 12,  3,  3
+        };
+        const uint8_t anchors3b[64] = {
+            15,  8,  8,  3, 15, 15,  3,  8, 15, 15, 15, 15, 15, 15, 15,  8,
+            15,  8, 15,  3, 15,  8, 15,  8,  3, 15,  6, 10, 15, 15, 10,  8,
+            15,  3, 15, 10, 10,  8,  9, 10,  6, 15,  8, 15,  3,  6,  6,  8,
+            15,  3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,  3, 15, 15,  8
+        };
+
+        // Interpolation weights out of 64 for indices of 2, 3 and 4 bits.
+        const uint8_t weights2[4] = { 0, 21, 43, 64 };
+        const uint8_t weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+        const uint8_t weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        inline const uint8_t* weightTable(int indexBits)
+        {
+            return indexBits == 2 ? weights2 : indexBits == 3 ? weights3 : weights4;
+        }
+
+        inline int interpolate(int e0, int e1, int weight)
+        {
+            return ((64 - weight) * e0 + weight * e1 + 32) >> 6;
+        }
+
+        // The subset of every pixel and the anchor pixel of every subset of a BC6H or BC7 partition.
+        inline void partitionOf(int numSubsets, int partition, uint8_t subsets[16], int anchors[3])
+        {
+            anchors[0] = 0;
+            anchors[1] = anchors[2] = -1;
+            if (numSubsets == 1)
+                memset(subsets, 0, 16);
+            else if (numSubsets == 2)
+            {
+                for (int i = 0; i < 16; ++i)
+                    subsets[i] = (uint8_t)((partitions2[partition] >> i) & 1);
+                anchors[1] = anchors2[partition];
+            }
+            else
+            {
+                memcpy(subsets, partitions3[partition], 16);
+                anchors[1] = anchors3a[partition];
+                anchors[2] = anchors3b[partition];
+            }
+        }
+
+        // BC7 modes 0 to 7, selected by the position of the first 1 bit of the block.
+        struct Bc7Mode
+        {
+            uint8_t numSubsets;
+            uint8_t partitionBits;
+            uint8_t rotationBits;
+            uint8_t indexSelectionBits;
+            uint8_t colorBits;
+            uint8_t alphaBits;
+            uint8_t endpointPBits; // one p-bit per endpoint
+            uint8_t sharedPBits;   // one p-bit per subset
+            uint8_t indexBits;
+            uint8_t indexBits2;    // second set of indices, for alpha or for color as the index selection bit says
+        };
+
+        const Bc7Mode bc7Modes[8] = {
+            { 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+            { 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+            { 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+            { 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+            { 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+            { 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+            { 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+            { 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 }
+        };
+
+        // Scales an endpoint of bits bits to 8 bits, its top bits repeated in the bottom ones.
+        inline int expandBits(int v, int bits)
+        {
+            v <<= 8 - bits;
+            return v | (v >> bits);
+        }
+
+        void decodeBC7(const uint8_t* block, uint8_t* dst, size_t stride)
+        {
+            BlockBits bits(block);
+            int mode = 0;
+            while (mode < 8 && !bits.read(1))
+                ++mode;
+            if (mode == 8)
+            {
+                // reserved mode: transparent black
+                for (int y = 0; y < 4; ++y)
+                    memset(dst + y * stride, 0, 16);
+                return;
+            }
+            const Bc7Mode& m = bc7Modes[mode];
+            const int partition = (int)bits.read(m.partitionBits);
+            const int rotation = (int)bits.read(m.rotationBits);
+            const int indexSelection = (int)bits.read(m.indexSelectionBits);
+
+            // endpoint 2 * s + e is endpoint e of subset s
+            const int numEndpoints = 2 * m.numSubsets;
+            int endpoints[6][4];
+            for (int c = 0; c < 3; ++c)
+                for (int i = 0; i < numEndpoints; ++i)
+                    endpoints[i][c] = (int)bits.read(m.colorBits);
+            for (int i = 0; i < numEndpoints; ++i)
+                endpoints[i][3] = (int)bits.read(m.alphaBits);
+
+            int colorBits = m.colorBits, alphaBits = m.alphaBits;
+            if (m.endpointPBits || m.sharedPBits)
+            {
+                for (int i = 0; i < numEndpoints; ++i)
+                {
+                    const int p = (m.endpointPBits || (i & 1) == 0) ? (int)bits.read(1) : endpoints[i - 1][0] & 1;
+                    for (int c = 0; c < 4; ++c)
+                        endpoints[i][c] = (endpoints[i][c] << 1) | p;
+                }
+                ++colorBits;
+                if (alphaBits)
+                    ++alphaBits;
+            }
+            for (int i = 0; i < numEndpoints; ++i)
+            {
+                for (int c = 0; c < 3; ++c)
+                    endpoints[i][c] = expandBits(endpoints[i][c], colorBits);
+                endpoints[i][3] = alphaBits ? expandBits(endpoints[i][3], alphaBits) : 255;
+            }
+
+            uint8_t subsets[16];
+            int anchors[3];
+            partitionOf(m.numSubsets, partition, subsets, anchors);
+            uint8_t indices[16], indices2[16];
+            for (int i = 0; i < 16; ++i)
+            {
+                const bool anchor = i == anchors[0] || i == anchors[1] || i == anchors[2];
+                indices[i] = (uint8_t)bits.read(m.indexBits - (anchor ? 1 : 0));
+            }
+            if (m.indexBits2)
+            {
+                for (int i = 0; i < 16; ++i)
+                    indices2[i] = (uint8_t)bits.read(m.indexBits2 - (i == 0 ? 1 : 0));
+            }
+
+            const uint8_t* colorWeights = weightTable(m.indexBits);
+            const uint8_t* alphaWeights = colorWeights;
+            const uint8_t* colorIndices = indices;
+            const uint8_t* alphaIndices = indices;
+            if (m.indexBits2)
+            {
+                alphaWeights = weightTable(m.indexBits2);
+                alphaIndices = indices2;
+                if (indexSelection)
+                {
+                    std::swap(colorWeights, alphaWeights);
+                    std::swap(colorIndices, alphaIndices);
+                }
+            }
+
+            for (int i = 0; i < 16; ++i)
+            {
+                const int* e0 = endpoints[2 * subsets[i]];
+                const int* e1 = endpoints[2 * subsets[i] + 1];
+                const int cw = colorWeights[colorIndices[i]];
+                const int aw = alphaWeights[alphaIndices[i]];
+                uint8_t px[4];
+                px[0] = (uint8_t)interpolate(e0[0], e1[0], cw);
+                px[1] = (uint8_t)interpolate(e0[1], e1[1], cw);
+                px[2] = (uint8_t)interpolate(e0[2], e1[2], cw);
+                px[3] = (uint8_t)interpolate(e0[3], e1[3], aw);
+                // rotation 1 to 3 swaps alpha with red, green or blue
+                if (rotation)
+                    std::swap(px[3], px[rotation - 1]);
+                memcpy(dst + (i >> 2) * stride + (i & 3) * 4, px, 4);
+            }
+        }
+
+        // One run of endpoint bits in a BC6H block: count bits of channel (0 red, 1 green, 2 blue) of endpoint
+        // (0 to 3, w x y z in the spec) from bit shift up, or from bit shift down when reversed.
+        struct Bc6hField
+        {
+            uint8_t endpoint, channel, shift, count, reversed;
+        };
+
+        // BC6H modes: the value of their mode bits, 2 for modes 1 and 2 and 5 for the others, the number of
+        // regions, whether endpoints 1 to 3 are deltas from endpoint 0, the bits of endpoint 0 and of the deltas
+        // per channel, and where the endpoint bits are in the block, as the spec lists them.
+        struct Bc6hMode
+        {
+            uint8_t modeBits;
+            uint8_t numRegions;
+            uint8_t transformed;
+            uint8_t endpointBits;
+            uint8_t deltaBits[3];
+            Bc6hField fields[24];
+        };
+
+#define F(e, c, s, n) { e, c, s, n, 0 }
+#define FR(e, c, s, n) { e, c, s, n, 1 }
+        const Bc6hMode bc6hModes[14] = {
+            { 0x00, 2, 1, 10, { 5, 5, 5 }, { F(2, 1, 4, 1), F(2, 2, 4, 1), F(3, 2, 4, 1), F(0, 0, 0, 10), F(0, 1, 0, 10), F(0, 2, 0, 10),
+                F(1, 0, 0, 5), F(3, 1, 4, 1), F(2, 1, 0, 4), F(1, 1, 0, 5), F(3, 2, 0, 1), F(3, 1, 0, 4), F(1, 2, 0, 5), F(3, 2, 1, 1),
+                F(2, 2, 0, 4), F(2, 0, 0, 5), F(3, 2, 2, 1), F(3, 0, 0, 5), F(3, 2, 3, 1) } },
+            { 0x01, 2, 1, 7, { 6, 6, 6 }, { F(2, 1, 5, 1), F(3, 1, 4, 1), F(3, 1, 5, 1), F(0, 0, 0, 7), F(3, 2, 0, 1), F(3, 2, 1, 1),
+                F(2, 2, 4, 1), F(0, 1, 0, 7), F(2, 2, 5, 1), F(3, 2, 2, 1), F(2, 1, 4, 1), F(0, 2, 0, 7), F(3, 2, 3, 1), F(3, 2, 5, 1),
+                F(3, 2, 4, 1), F(1, 0, 0, 6), F(2, 1, 0, 4), F(1, 1, 0, 6), F(3, 1, 0, 4), F(1, 2, 0, 6), F(2, 2, 0, 4), F(2, 0, 0, 6),
+                F(3, 0, 0, 6) } },
+            { 0x02, 2, 1, 11, { 5, 4, 4 }, { F(0, 0, 0, 10), F(0, 1, 0, 10), F(0, 2, 0, 10), F(1, 0, 0, 5), F(0, 0, 10, 1),
+                F(2, 1, 0, 4), F(1, 1, 0, 4), F(0, 1, 10, 1), F(3, 2, 0, 1), F(3, 1, 0, 4), F(1, 2, 0, 4), F(0, 2, 10, 1),
+                F(3, 2, 1, 1), F(2, 2, 0, 4), F(2, 0, 0, 5), F(3, 2, 2, 1), F(3, 0, 0, 5), F(3, 2, 3, 1) } },
+            { 0x06, 2, 1, 11, { 4, 5, 4 }, { F(0, 0, 0, 10), F(0, 1, 0, 10), F(0, 2, 0, 10), F(1, 0, 0, 4), F(0, 0, 10, 1),
+                F(3, 1, 4, 1), F(2, 1, 0, 4), F(1, 1, 0, 5), F(0, 1, 10, 1), F(3, 1, 0, 4), F(1, 2, 0, 4), F(0, 2, 10, 1),
+                F(3, 2, 1, 1), F(2, 2, 0, 4), F(2, 0, 0, 4), F(3, 2, 0, 1), F(3, 2, 2, 1), F(3, 0, 0, 4), F(2, 1, 4, 1),
+                F(3, 2, 3, 1) } },
+            { 0x0A, 2, 1, 11, { 4, 4, 5 }, { F(0, 0, 0, 10), F(0, 1, 0, 10), F(0, 2, 0, 10), F(1, 0, 0, 4), F(0, 0, 10, 1),
+                F(2, 2, 4, 1), F(2, 1, 0, 4), F(1, 1, 0, 4), F(0, 1, 10, 1), F(3, 2, 0, 1), F(3, 1, 0, 4), F(1, 2, 0, 5),
+                F(0, 2, 10, 1), F(2, 2, 0, 4), F(2, 0, 0, 4), F(3, 2, 1, 1), F(3, 2, 2, 1), F(3, 0, 0, 4), F(3, 2, 4, 1),
+                F(3, 2, 3, 1) } },
+            { 0x0E, 2, 1, 9, { 5, 5, 5 }, { F(0, 0, 0, 9), F(2, 2, 4, 1), F(0, 1, 0, 9), F(2, 1, 4, 1), F(0, 2, 0, 9), F(3, 2, 4, 1),
+                F(1, 0, 0, 5), F(3, 1, 4, 1), F(2, 1, 0, 4), F(1, 1, 0, 5), F(3, 2, 0, 1), F(3, 1, 0, 4), F(1, 2, 0, 5), F(3, 2, 1, 1),
+                F(2, 2, 0, 4), F(2, 0, 0, 5), F(3, 2, 2, 1), F(3, 0, 0, 5), F(3, 2, 3, 1) } },
+            { 0x12, 2, 1, 8, { 6, 5, 5 }, { F(0, 0, 0, 8), F(3, 1, 4, 1), F(2, 2, 4, 1), F(0, 1, 0, 8), F(3, 2, 2, 1), F(2, 1, 4, 1),
+                F(0, 2, 0, 8), F(3, 2, 3, 1), F(3, 2, 4, 1), F(1, 0, 0, 6), F(2, 1, 0, 4), F(1, 1, 0, 5), F(3, 2, 0, 1), F(3, 1, 0, 4),
+                F(1, 2, 0, 5), F(3, 2, 1, 1), F(2, 2, 0, 4), F(2, 0, 0, 6), F(3, 0, 0, 6) } },
+            { 0x16, 2, 1, 8, { 5, 6, 5 }, { F(0, 0, 0, 8), F(3, 2, 0, 1), F(2, 2, 4, 1), F(0, 1, 0, 8), F(2, 1, 5, 1), F(2, 1, 4, 1),
+                F(0, 2, 0, 8), F(3, 1, 5, 1), F(3, 2, 4, 1), F(1, 0, 0, 5), F(3, 1, 4, 1), F(2, 1, 0, 4), F(1, 1, 0, 6), F(3, 1, 0, 4),
+                F(1, 2, 0, 5), F(3, 2, 1, 1), F(2, 2, 0, 4), F(2, 0, 0, 5), F(3, 2, 2, 1), F(3, 0, 0, 5), F(3, 2, 3, 1) } },
+            { 0x1A, 2, 1, 8, { 5, 5, 6 }, { F(0, 0, 0, 8), F(3, 2, 1, 1), F(2, 2, 4, 1), F(0, 1, 0, 8), F(2, 2, 5, 1), F(2, 1, 4, 1),
+                F(0, 2, 0, 8), F(3, 2, 5, 1), F(3, 2, 4, 1), F(1, 0, 0, 5), F(3, 1, 4, 1), F(2, 1, 0, 4), F(1, 1, 0, 5), F(3, 2, 0, 1),
+                F(3, 1, 0, 4), F(1, 2, 0, 6), F(2, 2, 0, 4), F(2, 0, 0, 5), F(3, 2, 2, 1), F(3, 0, 0, 5), F(3, 2, 3, 1) } },
+            { 0x1E, 2, 0, 6, { 6, 6, 6 }, { F(0, 0, 0, 6), F(3, 1, 4, 1), F(3, 2, 0, 1), F(3, 2, 1, 1), F(2, 2, 4, 1), F(0, 1, 0, 6),
+                F(2, 1, 5, 1), F(2, 2, 5, 1), F(3, 2, 2, 1), F(2, 1, 4, 1), F(0, 2, 0, 6), F(3, 1, 5, 1), F(3, 2, 3, 1), F(3, 2, 5, 1),
+                F(3, 2, 4, 1), F(1, 0, 0, 6), F(2, 1, 0, 4), F(1, 1, 0, 6), F(3, 1, 0, 4), F(1, 2, 0, 6), F(2, 2, 0, 4), F(2, 0, 0, 6),
+                F(3, 0, 0, 6) } },
+            { 0x03, 1, 0, 10, { 10, 10, 10 }, { F(0, 0, 0, 10), F(0, 1, 0, 10), F(0, 2, 0, 10), F(1, 0, 0, 10), F(1, 1, 0, 10),
+                F(1, 2, 0, 10) } },
+            { 0x07, 1, 1, 11, { 9, 9, 9 }, { F(0, 0, 0, 10), F(0, 1, 0, 10), F(0, 2, 0, 10), F(1, 0, 0, 9), F(0, 0, 10, 1),
+                F(1, 1, 0, 9), F(0, 1, 10, 1), F(1, 2, 0, 9), F(0, 2, 10, 1) } },
+            { 0x0B, 1, 1, 12, { 8, 8, 8 }, { F(0, 0, 0, 10), F(0, 1, 0, 10), F(0, 2, 0, 10), F(1, 0, 0, 8), FR(0, 0, 11, 2),
+                F(1, 1, 0, 8), FR(0, 1, 11, 2), F(1, 2, 0, 8), FR(0, 2, 11, 2) } },
+            { 0x0F, 1, 1, 16, { 4, 4, 4 }, { F(0, 0, 0, 10), F(0, 1, 0, 10), F(0, 2, 0, 10), F(1, 0, 0, 4), FR(0, 0, 15, 6),
+                F(1, 1, 0, 4), FR(0, 1, 15, 6), F(1, 2, 0, 4), FR(0, 2, 15, 6) } }
+        };
+#undef F
+#undef FR
+
+        inline int signExtend(int v, int bits)
+        {
+            return (v ^ (1 << (bits - 1))) - (1 << (bits - 1));
+        }
+
+        // Scales an endpoint of bits bits to the 16 bit range the interpolation works in.
+        inline int unquantizeBC6H(int v, int bits, bool isSigned)
+        {
+            if (!isSigned)
+            {
+                if (bits >= 15 || v == 0)
+                    return v;
+                if (v == (1 << bits) - 1)
+                    return 0xFFFF;
+                return ((v << 16) + 0x8000) >> bits;
+            }
+            if (bits >= 16)
+                return v;
+            const bool negative = v < 0;
+            if (negative)
+                v = -v;
+            if (v >= (1 << (bits - 1)) - 1)
+                v = 0x7FFF;
+            else if (v != 0)
+                v = ((v << 15) + 0x4000) >> (bits - 1);
+            return negative ? -v : v;
+        }
+
+        // Interpolated value to the bits of a half float, and from there to a float.
+        inline float finishBC6H(int v, bool isSigned)
+        {
+            unsigned half;
+            if (!isSigned)
+                half = (unsigned)((v * 31) >> 6);
+            else if (v < 0)
+                half = 0x8000 | (unsigned)(((-v) * 31) >> 5);
+            else
+                half = (unsigned)((v * 31) >> 5);
+
+            const unsigned sign = (half & 0x8000) << 16;
+            unsigned exponent = (half >> 10) & 31;
+            unsigned mantissa = half & 0x3FF;
+            unsigned bits;
+            if (exponent == 0)
+            {
+                if (mantissa == 0)
+                    bits = sign;
+                else
+                {
+                    // denormal: normalize the mantissa
+                    exponent = 127 - 15 + 1;
+                    while (!(mantissa & 0x400))
+                    {
+                        mantissa <<= 1;
+                        --exponent;
+                    }
+                    bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+                }
+            }
+            else
+                bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+            float f;
+            memcpy(&f, &bits, 4);
+            return f;
+        }
+
+        // Writes the 4x4 pixels of a BC6H block as RGB floats.
+        template <bool isSigned>
+        void decodeBC6H(const uint8_t* block, uint8_t* dst, size_t stride)
+        {
+            BlockBits bits(block);
+            unsigned modeBits = bits.read(2);
+            if (modeBits >= 2)
+                modeBits |= bits.read(3) << 2;
+            const Bc6hMode* m = nullptr;
+            for (const Bc6hMode& mode : bc6hModes)
+            {
+                if (mode.modeBits == modeBits)
+                {
+                    m = &mode;
+                    break;
+                }
+            }
+            if (!m)
+            {
+                // reserved mode: black
+                for (int y = 0; y < 4; ++y)
+                    memset(dst + y * stride, 0, 4 * 3 * sizeof(float));
+                return;
+            }
+
+            int endpoints[4][3] = {};
+            for (const Bc6hField& f : m->fields)
+            {
+                if (f.count == 0)
+                    break;
+                const unsigned v = bits.read(f.count);
+                if (!f.reversed)
+                    endpoints[f.endpoint][f.channel] |= (int)(v << f.shift);
+                else
+                {
+                    for (int i = 0; i < f.count; ++i)
+                        endpoints[f.endpoint][f.channel] |= (int)((v >> i) & 1) << (f.shift - i);
+                }
+            }
+            const int partition = m->numRegions == 2 ? (int)bits.read(5) : 0;
+
+            const int numEndpoints = 2 * m->numRegions;
+            const int epb = m->endpointBits;
+            for (int c = 0; c < 3; ++c)
+            {
+                if (isSigned)
+                    endpoints[0][c] = signExtend(endpoints[0][c], epb);
+                for (int i = 1; i < numEndpoints; ++i)
+                {
+                    if (m->transformed)
+                    {
+                        // deltas from endpoint 0, wrapped to the endpoint's bits
+                        endpoints[i][c] = (endpoints[0][c] + signExtend(endpoints[i][c], m->deltaBits[c])) & ((1 << epb) - 1);
+                        if (isSigned)
+                            endpoints[i][c] = signExtend(endpoints[i][c], epb);
+                    }
+                    else if (isSigned)
+                        endpoints[i][c] = signExtend(endpoints[i][c], epb);
+                }
+                for (int i = 0; i < numEndpoints; ++i)
+                    endpoints[i][c] = unquantizeBC6H(endpoints[i][c], epb, isSigned);
+            }
+
+            uint8_t subsets[16];
+            int anchors[3];
+            partitionOf(m->numRegions, partition, subsets, anchors);
+            const int indexBits = m->numRegions == 2 ? 3 : 4;
+            const uint8_t* weights = weightTable(indexBits);
+            for (int i = 0; i < 16; ++i)
+            {
+                const bool anchor = i == anchors[0] || i == anchors[1];
+                const int w = weights[bits.read(indexBits - (anchor ? 1 : 0))];
+                const int* e0 = endpoints[2 * subsets[i]];
+                const int* e1 = endpoints[2 * subsets[i] + 1];
+                float px[3];
+                for (int c = 0; c < 3; ++c)
+                    px[c] = finishBC6H(interpolate(e0[c], e1[c], w), isSigned);
+                memcpy(dst + (i >> 2) * stride + (i & 3) * sizeof(px), px, sizeof(px));
+            }
+        }
+
+        // Decodes the blocks of rows of blocks [by0, by1). Blocks fully inside the image are written straight into
+        // pixels of P bytes; those on the right and bottom edges, when w or h are not multiples of 4, go through a 4x4
+        // buffer.
+        template <void (*decodeBlock)(const uint8_t*, uint8_t*, size_t), int P, int B>
+        void decodeBlockRows(const uint8_t* blocks, int w, int h, int by0, int by1, uint8_t* pixels)
+        {
+            const int bw = (w + 3) / 4;
+            const size_t stride = (size_t)w * P;
+            uint8_t tmp[4 * 4 * P];
+            for (int by = by0; by < by1; ++by)
+            {
+                const uint8_t* src = blocks + (size_t)by * bw * B;
+                uint8_t* dst = pixels + (size_t)by * 4 * stride;
+                const int rows = std::min(4, h - by * 4);
+                const int fullBlocks = rows == 4 ? w / 4 : 0;
+                int bx = 0;
+                for (; bx < fullBlocks; ++bx)
+                    decodeBlock(src + (size_t)bx * B, dst + (size_t)bx * 4 * P, stride);
+                for (; bx < bw; ++bx)
+                {
+                    decodeBlock(src + (size_t)bx * B, tmp, 4 * P);
+                    const int cols = std::min(4, w - bx * 4);
+                    for (int y = 0; y < rows; ++y)
+                        memcpy(dst + y * stride + (size_t)bx * 4 * P, tmp + y * 4 * P, (size_t)cols * P);
+                }
+            }
+        }
+
+        template <void (*decodeBlock)(const uint8_t*, uint8_t*, size_t), int P, int B>
+        void decodeSurface(const uint8_t* blocks, int w, int h, uint8_t* pixels, unsigned numThreads)
+        {
+            const int bw = (w + 3) / 4;
+            const int bh = (h + 3) / 4;
+            // Bands of block rows of at least 1024 blocks, so that small images are not split into tasks that
+            // cost more to hand out than to decode.
+            const int band = std::max(1, 1024 / bw);
+            const size_t numBands = ((size_t)bh + band - 1) / band;
+            ImageCodecs::ThreadPool::global().parallelFor(0, numBands, [&](size_t i) {
+                const int by0 = (int)i * band;
+                decodeBlockRows<decodeBlock, P, B>(blocks, w, h, by0, std::min(bh, by0 + band), pixels);
+            }, numThreads);
+        }
+
+        // The 4x4 pixels of the block at (bx, by) as RGBA, gray spread to RGB and alpha 255 when there is none.
+        // Pixels past the right and bottom edges repeat the last column and row, which adds no colors the endpoints
+        // have to cover.
+        void loadBlock(const uint8_t* pixels, int w, int h, int channels, int bx, int by, uint8_t block[16][4])
+        {
+            for (int y = 0; y < 4; ++y)
+            {
+                const int sy = std::min(by * 4 + y, h - 1);
+                for (int x = 0; x < 4; ++x)
+                {
+                    const int sx = std::min(bx * 4 + x, w - 1);
+                    const uint8_t* p = pixels + ((size_t)sy * w + sx) * channels;
+                    uint8_t* q = block[y * 4 + x];
+                    switch (channels)
+                    {
+                    case 1:
+                        q[0] = q[1] = q[2] = p[0];
+                        q[3] = 255;
+                        break;
+                    case 2:
+                        q[0] = q[1] = q[2] = p[0];
+                        q[3] = p[1];
+                        break;
+                    case 3:
+                        memcpy(q, p, 3);
+                        q[3] = 255;
+                        break;
+                    default:
+                        memcpy(q, p, 4);
+                        break;
+                    }
+                }
+            }
+        }
+
+        // The colors of a block for the BC1 color encoder, channel by channel so that 4 pixels fill an SSE2
+        // register. Pixels BC1 leaves transparent have a weight of 0 and do not count towards the error.
+        struct ColorPixels
+        {
+            alignas(16) float r[16];
+            alignas(16) float g[16];
+            alignas(16) float b[16];
+            alignas(16) float weight[16];
+        };
+
+        inline void expand565(unsigned c, int rgb[3])
+        {
+            rgb[0] = expandBits((c >> 11) & 31, 5);
+            rgb[1] = expandBits((c >> 5) & 63, 6);
+            rgb[2] = expandBits(c & 31, 5);
+        }
+
+        inline unsigned quantize565(const float rgb[3])
+        {
+            const int r = std::min(31, std::max(0, (int)(rgb[0] * 31.0f / 255.0f + 0.5f)));
+            const int g = std::min(63, std::max(0, (int)(rgb[1] * 63.0f / 255.0f + 0.5f)));
+            const int b = std::min(31, std::max(0, (int)(rgb[2] * 31.0f / 255.0f + 0.5f)));
+            return (unsigned)((r << 11) | (g << 5) | b);
+        }
+
+        // The palette colorPalette() makes from the endpoints c0 and c1, in the order given: 4 colors, or 3 with
+        // threeColors.
+        void endpointPalette(unsigned c0, unsigned c1, bool threeColors, float pal[4][3])
+        {
+            int e0[3], e1[3];
+            expand565(c0, e0);
+            expand565(c1, e1);
+            for (int c = 0; c < 3; ++c)
+            {
+                pal[0][c] = (float)e0[c];
+                pal[1][c] = (float)e1[c];
+                if (threeColors)
+                {
+                    pal[2][c] = (float)((e0[c] + e1[c] + 1) / 2);
+                    pal[3][c] = 0.0f;
+                }
+                else
+                {
+                    pal[2][c] = (float)((2 * e0[c] + e1[c] + 1) / 3);
+                    pal[3][c] = (float)((e0[c] + 2 * e1[c] + 1) / 3);
+                }
+            }
+        }
+
+        // Index of the nearest of the first n colors of pal for every pixel, and the sum of the squared distances of
+        // the pixels that count. All values are whole numbers far inside the 24 bits of a float, so the SSE2 path,
+        // which does 4 pixels at a time, gives the same indices and sum as the plain one.
+        float fitColorIndices(const ColorPixels& px, const float pal[4][3], int n, uint8_t indices[16])
+        {
+#ifdef BCN_SSE2
+            __m128 total = _mm_setzero_ps();
+            for (int i = 0; i < 16; i += 4)
+            {
+                const __m128 r = _mm_load_ps(px.r + i);
+                const __m128 g = _mm_load_ps(px.g + i);
+                const __m128 b = _mm_load_ps(px.b + i);
+                __m128 best = _mm_set1_ps(FLT_MAX);
+                __m128i bestIndex = _mm_setzero_si128();
+                for (int k = 0; k < n; ++k)
+                {
+                    const __m128 dr = _mm_sub_ps(r, _mm_set1_ps(pal[k][0]));
+                    const __m128 dg = _mm_sub_ps(g, _mm_set1_ps(pal[k][1]));
+                    const __m128 db = _mm_sub_ps(b, _mm_set1_ps(pal[k][2]));
+                    const __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+                    const __m128i closer = _mm_castps_si128(_mm_cmplt_ps(d, best));
+                    best = _mm_min_ps(d, best);
+                    bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(k)), _mm_andnot_si128(closer, bestIndex));
+                }
+                total = _mm_add_ps(total, _mm_mul_ps(best, _mm_load_ps(px.weight + i)));
+                alignas(16) int32_t index[4];
+                _mm_store_si128((__m128i*)index, bestIndex);
+                for (int j = 0; j < 4; ++j)
+                    indices[i + j] = (uint8_t)index[j];
+            }
+            alignas(16) float sums[4];
+            _mm_store_ps(sums, total);
+            return sums[0] + sums[1] + sums[2] + sums[3];
+#else
+            float total = 0.0f;
+            for (int i = 0; i < 16; ++i)
+            {
+                float best = FLT_MAX;
+                int bestIndex = 0;
+                for (int k = 0; k < n; ++k)
+                {
+                    const float dr = px.r[i] - pal[k][0];
+                    const float dg = px.g[i] - pal[k][1];
+                    const float db = px.b[i] - pal[k][2];
+                    const float d = dr * dr + dg * dg + db * db;
+                    if (d < best)
+                    {
+                        best = d;
+                        bestIndex = k;
+                    }
+                }
+                indices[i] = (uint8_t)bestIndex;
+                total += best * px.weight[i];
+            }
+            return total;
+#endif
+        }
+
+        // Endpoints, indices and error of the best color block found so far.
+        struct ColorFit
+        {
+            unsigned c0, c1;
+            uint8_t indices[16];
+            float error;
+        };
+
+        inline void tryColorEndpoints(const ColorPixels& px, unsigned c0, unsigned c1, bool threeColors, ColorFit& fit)
+        {
+            float pal[4][3];
+            endpointPalette(c0, c1, threeColors, pal);
+            uint8_t indices[16];
+            const float error = fitColorIndices(px, pal, threeColors ? 3 : 4, indices);
+            if (error < fit.error)
+            {
+                fit.c0 = c0;
+                fit.c1 = c1;
+                memcpy(fit.indices, indices, 16);
+                fit.error = error;
+            }
+        }
+
+        // Endpoints of the line through the colors that count. Without pca, the corners of their bounding box, moved
+        // in by 1/16 of its size as the palette lies between the endpoints, with the channels that fall as the widest
+        // one rises swapped; with pca, the ends of the colors along their principal axis.
+        void fitColorLine(const ColorPixels& px, bool pca, float e0[3], float e1[3])
+        {
+            const float* ch[3] = { px.r, px.g, px.b };
+            float n = 0.0f, mean[3] = {}, lo[3] = { 255.0f, 255.0f, 255.0f }, hi[3] = {};
+            for (int i = 0; i < 16; ++i)
+            {
+                if (px.weight[i] == 0.0f)
+                    continue;
+                n += 1.0f;
+                for (int c = 0; c < 3; ++c)
+                {
+                    mean[c] += ch[c][i];
+                    lo[c] = std::min(lo[c], ch[c][i]);
+                    hi[c] = std::max(hi[c], ch[c][i]);
+                }
+            }
+            for (int c = 0; c < 3; ++c)
+                mean[c] /= n;
+            float cov[3][3] = {};
+            for (int i = 0; i < 16; ++i)
+            {
+                if (px.weight[i] == 0.0f)
+                    continue;
+                const float d[3] = { ch[0][i] - mean[0], ch[1][i] - mean[1], ch[2][i] - mean[2] };
+                for (int a = 0; a < 3; ++a)
+                    for (int b = 0; b < 3; ++b)
+                        cov[a][b] += d[a] * d[b];
+            }
+
+            if (!pca)
+            {
+                int widest = 0;
+                for (int c = 1; c < 3; ++c)
+                    if (hi[c] - lo[c] > hi[widest] - lo[widest])
+                        widest = c;
+                for (int c = 0; c < 3; ++c)
+                {
+                    const float inset = (hi[c] - lo[c]) / 16.0f;
+                    e0[c] = hi[c] - inset;
+                    e1[c] = lo[c] + inset;
+                    if (cov[c][widest] < 0.0f)
+                        std::swap(e0[c], e1[c]);
+                }
+                return;
+            }
+
+            // power iteration from the row of the channel that varies most
+            int k = 0;
+            for (int c = 1; c < 3; ++c)
+                if (cov[c][c] > cov[k][k])
+                    k = c;
+            float axis[3] = { cov[k][0], cov[k][1], cov[k][2] };
+            for (int it = 0; it < 8; ++it)
+            {
+                float next[3];
+                for (int a = 0; a < 3; ++a)
+                    next[a] = cov[a][0] * axis[0] + cov[a][1] * axis[1] + cov[a][2] * axis[2];
+                const float m = std::max(std::fabs(next[0]), std::max(std::fabs(next[1]), std::fabs(next[2])));
+                if (m == 0.0f)
+                    break;
+                for (int a = 0; a < 3; ++a)
+                    axis[a] = next[a] / m;
+            }
+            const float length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+            if (length == 0.0f)
+            {
+                memcpy(e0, mean, sizeof(mean));
+                memcpy(e1, mean, sizeof(mean));
+                return;
+            }
+            for (int a = 0; a < 3; ++a)
+                axis[a] /= length;
+
+            float tmin = FLT_MAX, tmax = -FLT_MAX;
+            for (int i = 0; i < 16; ++i)
+            {
+                if (px.weight[i] == 0.0f)
+                    continue;
+                const float t = (ch[0][i] - mean[0]) * axis[0] + (ch[1][i] - mean[1]) * axis[1] + (ch[2][i] - mean[2]) * axis[2];
+                tmin = std::min(tmin, t);
+                tmax = std::max(tmax, t);
+            }
+            for (int c = 0; c < 3; ++c)
+            {
+                e0[c] = std::min(255.0f, std::max(0.0f, mean[c] + tmax * axis[c]));
+                e1[c] = std::min(255.0f, std::max(0.0f, mean[c] + tmin * axis[c]));
+            }
+        }
+
+        // Least squares endpoints for the indices of fit: the line that best matches the pixels at the points their
+        // indices put them on. False when every pixel has the same index, which leaves the line open.
+        bool refineColorLine(const ColorPixels& px, const ColorFit& fit, bool threeColors, float e0[3], float e1[3])
+        {
+            // how much of endpoint 0 each index takes
+            static const float share4[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+            static const float share3[4] = { 1.0f, 0.0f, 0.5f, 0.0f };
+            const float* share = threeColors ? share3 : share4;
+            const float* ch[3] = { px.r, px.g, px.b };
+            float aa = 0.0f, ab = 0.0f, bb = 0.0f, ax[3] = {}, bx[3] = {};
+            for (int i = 0; i < 16; ++i)
+            {
+                if (px.weight[i] == 0.0f)
+                    continue;
+                const float a = share[fit.indices[i]], b = 1.0f - a;
+                aa += a * a;
+                ab += a * b;
+                bb += b * b;
+                for (int c = 0; c < 3; ++c)
+                {
+                    ax[c] += a * ch[c][i];
+                    bx[c] += b * ch[c][i];
+                }
+            }
+            const float det = aa * bb - ab * ab;
+            if (det < 1e-3f)
+                return false;
+            for (int c = 0; c < 3; ++c)
+            {
+                e0[c] = std::min(255.0f, std::max(0.0f, (bb * ax[c] - ab * bx[c]) / det));
+                e1[c] = std::min(255.0f, std::max(0.0f, (aa * bx[c] - ab * ax[c]) / det));
+            }
+            return true;
+        }
+
+        // Endpoints for blocks of one color in the 4 color mode: the pair of 5 or 6 bit values whose palette entry 2
+        // comes closest to each 8 bit value, which is nearer than the color rounded to 565 on its own.
+        struct SingleColorTable
+        {
+            uint8_t hi[256], lo[256];
+
+            explicit SingleColorTable(int bits)
+            {
+                const int top = (1 << bits) - 1;
+                for (int v = 0; v < 256; ++v)
+                {
+                    int bestError = INT_MAX;
+                    for (int a = 0; a <= top; ++a)
+                    {
+                        for (int b = 0; b <= top; ++b)
+                        {
+                            const int ea = expandBits(a, bits), eb = expandBits(b, bits);
+                            // closest first, then endpoints close together, which decoders that round
+                            // differently agree on
+                            const int error = std::abs((2 * ea + eb + 1) / 3 - v) * 256 + std::abs(ea - eb);
+                            if (error < bestError)
+                            {
+                                bestError = error;
+                                hi[v] = (uint8_t)a;
+                                lo[v] = (uint8_t)b;
+                            }
+                        }
+                    }
+                }
+            }
+        };
+
+        // Writes the 8 bytes of a color block. BC1 blocks with pixels of alpha below 128 take the 3 color mode,
+        // whose index 3 is transparent black; the others, and all of BC3's, the 4 color mode. FAST fits endpoints
+        // to the bounding box of the colors, NORMAL to their principal axis refined by least squares, and BEST
+        // refines once more and then tries the neighbours of each endpoint channel.
+        void encodeColorBlock(const uint8_t block[16][4], bool bc1, Quality quality, uint8_t* out)
+        {
+            ColorPixels px;
+            unsigned transparent = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                px.r[i] = block[i][0];
+                px.g[i] = block[i][1];
+                px.b[i] = block[i][2];
+                const bool clear = bc1 && block[i][3] < 128;
+                px.weight[i] = clear ? 0.0f : 1.0f;
+                transparent |= (clear ? 1u : 0u) << i;
+            }
+            if (transparent == 0xFFFF)
+            {
+                memset(out, 0, 4);
+                memset(out + 4, 0xFF, 4);
+                return;
+            }
+            const bool threeColors = transparent != 0;
+
+            bool oneColor = true;
+            int first = 0;
+            while (px.weight[first] == 0.0f)
+                ++first;
+            for (int i = first + 1; i < 16 && oneColor; ++i)
+                oneColor = px.weight[i] == 0.0f ||
+                    (px.r[i] == px.r[first] && px.g[i] == px.g[first] && px.b[i] == px.b[first]);
+
+            ColorFit fit;
+            fit.error = FLT_MAX;
+            if (oneColor && !threeColors)
+            {
+                static const SingleColorTable table5(5), table6(6);
+                const int r = block[first][0], g = block[first][1], b = block[first][2];
+                tryColorEndpoints(px, (unsigned)((table5.hi[r] << 11) | (table6.hi[g] << 5) | table5.hi[b]),
+                    (unsigned)((table5.lo[r] << 11) | (table6.lo[g] << 5) | table5.lo[b]), false, fit);
+            }
+            else
+            {
+                float e0[3], e1[3];
+                fitColorLine(px, quality != Quality::FAST, e0, e1);
+                tryColorEndpoints(px, quantize565(e0), quantize565(e1), threeColors, fit);
+                const int refinements = quality == Quality::FAST ? 0 : quality == Quality::NORMAL ? 1 : 2;
+                for (int it = 0; it < refinements && fit.error > 0.0f; ++it)
+                {
+                    if (!refineColorLine(px, fit, threeColors, e0, e1))
+                        break;
+                    const unsigned c0 = quantize565(e0), c1 = quantize565(e1);
+                    if (c0 == fit.c0 && c1 == fit.c1)
+                        break;
+                    tryColorEndpoints(px, c0, c1, threeColors, fit);
+                }
+                if (quality == Quality::BEST)
+                {
+                    // one step up and down in each of the 6 endpoint channels, while that helps
+                    static const unsigned fields[3][2] = { { 11, 31 }, { 5, 63 }, { 0, 31 } };
+                    for (int pass = 0; pass < 2 && fit.error > 0.0f; ++pass)
+                    {
+                        const float before = fit.error;
+                        for (int e = 0; e < 2; ++e)
+                        {
+                            for (int f = 0; f < 3; ++f)
+                            {
+                                for (int step = -1; step <= 1; step += 2)
+                                {
+                                    const unsigned c = e == 0 ? fit.c0 : fit.c1;
+                                    const int v = (int)((c >> fields[f][0]) & fields[f][1]) + step;
+                                    if (v < 0 || v > (int)fields[f][1])
+                                        continue;
+                                    const unsigned moved = (c & ~(fields[f][1] << fields[f][0])) | ((unsigned)v << fields[f][0]);
+                                    if (e == 0)
+                                        tryColorEndpoints(px, moved, fit.c1, threeColors, fit);
+                                    else
+                                        tryColorEndpoints(px, fit.c0, moved, threeColors, fit);
+                                }
+                            }
+                        }
+                        if (fit.error == before)
+                            break;
+                    }
+                }
+            }
+
+            // The order of the endpoints selects the mode: c0 > c1 for 4 colors, c0 <= c1 for 3. Swapping them
+            // swaps indices 0 and 1, and 2 and 3 of 4 colors.
+            unsigned c0 = fit.c0, c1 = fit.c1;
+            uint8_t* indices = fit.indices;
+            if (!threeColors)
+            {
+                if (c0 < c1)
+                {
+                    std::swap(c0, c1);
+                    for (int i = 0; i < 16; ++i)
+                        indices[i] ^= 1;
+                }
+                else if (c0 == c1)
+                    memset(indices, 0, 16);
+            }
+            else
+            {
+                if (c0 > c1)
+                {
+                    std::swap(c0, c1);
+                    for (int i = 0; i < 16; ++i)
+                        if (indices[i] < 2)
+                            indices[i] ^= 1;
+                }
+                for (int i = 0; i < 16; ++i)
+                    if (transparent & (1u << i))
+                        indices[i] = 3;
+            }
+            out[0] = (uint8_t)c0;
+            out[1] = (uint8_t)(c0 >> 8);
+            out[2] = (uint8_t)c1;
+            out[3] = (uint8_t)(c1 >> 8);
+            for (int y = 0; y < 4; ++y)
+                out[4 + y] = (uint8_t)(indices[4 * y] | (indices[4 * y + 1] << 2) | (indices[4 * y + 2] << 4) | (indices[4 * y + 3] << 6));
+        }
+
+        // Sum of the squared distances of the values to the nearest of the palette of endpoints a0 and a1, and
+        // the index of each. Gives up, returning INT_MAX, once the sum passes limit.
+        int fitChannelIndices(const uint8_t values[16], int a0, int a1, int limit, uint8_t indices[16])
+        {
+            const uint8_t block[2] = { (uint8_t)a0, (uint8_t)a1 };
+            uint8_t pal[8];
+            channelPalette(block, false, pal);
+            int error = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                int best = INT_MAX, bestIndex = 0;
+                for (int k = 0; k < 8; ++k)
+                {
+                    const int d = (values[i] - pal[k]) * (values[i] - pal[k]);
+                    if (d < best)
+                    {
+                        best = d;
+                        bestIndex = k;
+                    }
+                }
+                indices[i] = (uint8_t)bestIndex;
+                error += best;
+                if (error >= limit)
+                    return INT_MAX;
+            }
+            return error;
+        }
+
+        // Writes the 8 bytes of a BC4 block, which is also the alpha of BC3. The 8 value mode spans the lowest to
+        // the highest value; unless quality is FAST, the 6 value mode, which has 0 and 255 of its own, is tried
+        // across the values between those, and BEST also moves each endpoint by up to 2.
+        void encodeChannelBlock(const uint8_t values[16], Quality quality, uint8_t* out)
+        {
+            int lo = 255, hi = 0, innerLo = 255, innerHi = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                lo = std::min(lo, (int)values[i]);
+                hi = std::max(hi, (int)values[i]);
+                if (values[i] != 0 && values[i] != 255)
+                {
+                    innerLo = std::min(innerLo, (int)values[i]);
+                    innerHi = std::max(innerHi, (int)values[i]);
+                }
+            }
+
+            int best = INT_MAX, a0 = lo, a1 = lo;
+            uint8_t indices[16], bestIndices[16] = {};
+            auto tryEndpoints = [&](int e0, int e1) {
+                const int error = fitChannelIndices(values, e0, e1, best, indices);
+                if (error < best)
+                {
+                    best = error;
+                    a0 = e0;
+                    a1 = e1;
+                    memcpy(bestIndices, indices, 16);
+                }
+            };
+            if (lo == hi)
+                tryEndpoints(lo, lo);
+            else
+            {
+                // a0 > a1 selects 8 values, a0 <= a1 6 values with 0 and 255
+                tryEndpoints(hi, lo);
+                if (quality != Quality::FAST)
+                {
+                    if (innerLo > innerHi)
+                        tryEndpoints(0, 0);
+                    else
+                        tryEndpoints(innerLo, innerHi);
+                }
+                if (quality == Quality::BEST && best > 0)
+                {
+                    const int e0 = a0, e1 = a1;
+                    for (int d0 = -2; d0 <= 2; ++d0)
+                    {
+                        for (int d1 = -2; d1 <= 2; ++d1)
+                        {
+                            const int m0 = e0 + d0, m1 = e1 + d1;
+                            if (m0 < 0 || m0 > 255 || m1 < 0 || m1 > 255 || (m0 > m1) != (e0 > e1))
+                                continue;
+                            tryEndpoints(m0, m1);
+                        }
+                    }
+                }
+            }
+
+            out[0] = (uint8_t)a0;
+            out[1] = (uint8_t)a1;
+            uint64_t bits = 0;
+            for (int i = 15; i >= 0; --i)
+                bits = (bits << 3) | bestIndices[i];
+            for (int i = 0; i < 6; ++i)
+                out[2 + i] = (uint8_t)(bits >> (8 * i));
+        }
+
+        void encodeBC1(const uint8_t block[16][4], Quality quality, uint8_t* out)
+        {
+            encodeColorBlock(block, true, quality, out);
+        }
+
+        void encodeBC3(const uint8_t block[16][4], Quality quality, uint8_t* out)
+        {
+            uint8_t alpha[16];
+            for (int i = 0; i < 16; ++i)
+                alpha[i] = block[i][3];
+            encodeChannelBlock(alpha, quality, out);
+            encodeColorBlock(block, false, quality, out + 8);
+        }
+
+        // Writes BC6H and BC7 fields from the least significant bit up, the way BlockBits reads them.
+        struct BlockWriter
+        {
+            uint64_t lo = 0, hi = 0;
+            int pos = 0;
+
+            inline void write(unsigned v, int n)
+            {
+                if (n == 0)
+                    return;
+                if (pos < 64)
+                {
+                    lo |= (uint64_t)v << pos;
+                    if (pos + n > 64)
+                        hi |= (uint64_t)v >> (64 - pos);
+                }
+                else
+                    hi |= (uint64_t)v << (pos - 64);
+                pos += n;
+            }
+
+            void store(uint8_t* out) const
+            {
+                for (int i = 0; i < 8; ++i)
+                {
+                    out[i] = (uint8_t)(lo >> (8 * i));
+                    out[i + 8] = (uint8_t)(hi >> (8 * i));
+                }
+            }
+        };
+
+        // An endpoint channel of bits bits and p-bit p (-1 for none) as the decoder expands it.
+        inline int expandBC7(int q, int bits, int p)
+        {
+            return p < 0 ? expandBits(q, bits) : expandBits((q << 1) | p, bits + 1);
+        }
+
+        // The value of bits bits with p-bit p (-1 for none) that expands closest to v.
+        int quantizeBC7(float v, int bits, int p)
+        {
+            const int top = (1 << bits) - 1;
+            int q;
+            if (p < 0)
+                q = (int)(v * top / 255.0f + 0.5f);
+            else
+                q = (int)((v * ((2 << bits) - 1) / 255.0f - p) * 0.5f + 0.5f);
+            q = std::min(top, std::max(0, q));
+            if (bits + (p < 0 ? 0 : 1) == 8)
+                return q; // expanding 8 bits changes nothing, so rounding found the nearest
+            int best = q;
+            float bestError = std::fabs(expandBC7(q, bits, p) - v);
+            for (int c = std::max(0, q - 1); c <= std::min(top, q + 1); ++c)
+            {
+                const float error = std::fabs(expandBC7(c, bits, p) - v);
+                if (error < bestError)
+                {
+                    bestError = error;
+                    best = c;
+                }
+            }
+            return best;
+        }
+
+        // What fitSubset() fits: channels [first, first + count) of bits[c] bits each before the p-bit, p-bits none
+        // (0), one per endpoint (1) or one for both (2), and indices of indexBits bits. opaque keeps to p-bits of 1,
+        // without which the alpha of modes 6 and 7 cannot reach 255.
+        struct SubsetSpec
+        {
+            int first, count;
+            int bits[4];
+            int pbits;
+            int indexBits;
+            bool opaque;
+            bool allPBits; // see tryBC7Endpoints()
+        };
+
+        struct SubsetFit
+        {
+            int q[2][4];   // endpoint channels before the p-bit
+            int p[2];      // -1 without p-bits
+            uint8_t indices[16];
+            int error;
+        };
+
+        // Indices and error of the endpoints of candidate for the pixels of mask; candidate becomes best when its
+        // error is lower. Gives up as soon as it cannot be.
+        void evaluateSubset(const int px[16][4], unsigned mask, const SubsetSpec& spec, SubsetFit& candidate, SubsetFit& best)
+        {
+            const int n = 1 << spec.indexBits;
+            const uint8_t* weights = weightTable(spec.indexBits);
+            const int c0 = spec.first, c1 = spec.first + spec.count;
+            int pal[16][4], e0[4], dir[4], length = 0;
+            for (int c = c0; c < c1; ++c)
+            {
+                e0[c] = expandBC7(candidate.q[0][c], spec.bits[c], candidate.p[0]);
+                const int e1 = expandBC7(candidate.q[1][c], spec.bits[c], candidate.p[1]);
+                for (int k = 0; k < n; ++k)
+                    pal[k][c] = interpolate(e0[c], e1, weights[k]);
+                dir[c] = e1 - e0[c];
+                length += dir[c] * dir[c];
+            }
+            // The palette runs in order from e0 to e1, so the entry nearest to a pixel is next to where the pixel
+            // falls on that line: only that one and its neighbours are measured.
+            const float scale = length ? (float)(n - 1) / length : 0.0f;
+            int error = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                if (!(mask & (1u << i)))
+                    continue;
+                int dot = 0;
+                for (int c = c0; c < c1; ++c)
+                    dot += (px[i][c] - e0[c]) * dir[c];
+                const int guess = std::min(n - 1, std::max(0, (int)(dot * scale + 0.5f)));
+                int bestDistance = INT_MAX, bestIndex = 0;
+                for (int k = std::max(0, guess - 1); k <= std::min(n - 1, guess + 1); ++k)
+                {
+                    int d = 0;
+                    for (int c = c0; c < c1; ++c)
+                        d += (px[i][c] - pal[k][c]) * (px[i][c] - pal[k][c]);
+                    if (d < bestDistance)
+                    {
+                        bestDistance = d;
+                        bestIndex = k;
+                    }
+                }
+                candidate.indices[i] = (uint8_t)bestIndex;
+                error += bestDistance;
+                if (error >= best.error)
+                    return;
+            }
+            candidate.error = error;
+            best = candidate;
+        }
+
+        // Quantizes the endpoints e0 and e1 and keeps them in fit if they do better. With spec.allPBits every choice
+        // of p-bits is measured, otherwise only the one that quantizes the endpoints themselves closest.
+        void tryBC7Endpoints(const int px[16][4], unsigned mask, const SubsetSpec& spec, const float e0[4], const float e1[4], SubsetFit& fit)
+        {
+            static const int pbitChoices[4][2] = { { 0, 0 }, { 1, 1 }, { 0, 1 }, { 1, 0 } };
+            const int choices = spec.pbits == 0 ? 1 : spec.pbits == 2 ? 2 : 4;
+            SubsetFit candidates[4];
+            float closest = FLT_MAX;
+            int chosen = -1;
+            for (int k = 0; k < choices; ++k)
+            {
+                const int p0 = spec.pbits ? pbitChoices[k][0] : -1;
+                const int p1 = spec.pbits ? pbitChoices[k][1] : -1;
+                if (spec.opaque && (p0 == 0 || p1 == 0))
+                    continue;
+                SubsetFit& candidate = candidates[k];
+                candidate.p[0] = p0;
+                candidate.p[1] = p1;
+                float distance = 0.0f;
+                for (int c = spec.first; c < spec.first + spec.count; ++c)
+                {
+                    candidate.q[0][c] = quantizeBC7(e0[c], spec.bits[c], p0);
+                    candidate.q[1][c] = quantizeBC7(e1[c], spec.bits[c], p1);
+                    const float d0 = expandBC7(candidate.q[0][c], spec.bits[c], p0) - e0[c];
+                    const float d1 = expandBC7(candidate.q[1][c], spec.bits[c], p1) - e1[c];
+                    distance += d0 * d0 + d1 * d1;
+                }
+                if (spec.allPBits)
+                    evaluateSubset(px, mask, spec, candidate, fit);
+                else if (distance < closest)
+                {
+                    closest = distance;
+                    chosen = k;
+                }
+            }
+            if (chosen >= 0)
+                evaluateSubset(px, mask, spec, candidates[chosen], fit);
+        }
+
+        // Fits the endpoints of one subset to the ends of its pixels along their principal axis, then refines them
+        // by least squares from the indices they give, iterations times.
+        void fitSubset(const int px[16][4], unsigned mask, const SubsetSpec& spec, int iterations, SubsetFit& fit)
+        {
+            const int c0 = spec.first, n = spec.count;
+            float mean[4] = {}, cov[4][4] = {};
+            int count = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                if (!(mask & (1u << i)))
+                    continue;
+                ++count;
+                for (int a = 0; a < n; ++a)
+                    mean[a] += (float)px[i][c0 + a];
+            }
+            for (int a = 0; a < n; ++a)
+                mean[a] /= (float)count;
+            for (int i = 0; i < 16; ++i)
+            {
+                if (!(mask & (1u << i)))
+                    continue;
+                for (int a = 0; a < n; ++a)
+                    for (int b = 0; b < n; ++b)
+                        cov[a][b] += (px[i][c0 + a] - mean[a]) * (px[i][c0 + b] - mean[b]);
+            }
+
+            int k = 0;
+            for (int a = 1; a < n; ++a)
+                if (cov[a][a] > cov[k][k])
+                    k = a;
+            float axis[4] = {};
+            for (int a = 0; a < n; ++a)
+                axis[a] = cov[k][a];
+            for (int it = 0; it < 4; ++it)
+            {
+                float next[4] = {}, m = 0.0f;
+                for (int a = 0; a < n; ++a)
+                {
+                    for (int b = 0; b < n; ++b)
+                        next[a] += cov[a][b] * axis[b];
+                    m = std::max(m, std::fabs(next[a]));
+                }
+                if (m == 0.0f)
+                    break;
+                for (int a = 0; a < n; ++a)
+                    axis[a] = next[a] / m;
+            }
+            float length = 0.0f;
+            for (int a = 0; a < n; ++a)
+                length += axis[a] * axis[a];
+            length = std::sqrt(length);
+
+            float e0[4], e1[4];
+            float tmin = 0.0f, tmax = 0.0f;
+            if (length > 0.0f)
+            {
+                for (int a = 0; a < n; ++a)
+                    axis[a] /= length;
+                tmin = FLT_MAX;
+                tmax = -FLT_MAX;
+                for (int i = 0; i < 16; ++i)
+                {
+                    if (!(mask & (1u << i)))
+                        continue;
+                    float t = 0.0f;
+                    for (int a = 0; a < n; ++a)
+                        t += (px[i][c0 + a] - mean[a]) * axis[a];
+                    tmin = std::min(tmin, t);
+                    tmax = std::max(tmax, t);
+                }
+            }
+            for (int a = 0; a < n; ++a)
+            {
+                e0[c0 + a] = std::min(255.0f, std::max(0.0f, mean[a] + tmin * axis[a]));
+                e1[c0 + a] = std::min(255.0f, std::max(0.0f, mean[a] + tmax * axis[a]));
+            }
+
+            fit.error = INT_MAX;
+            tryBC7Endpoints(px, mask, spec, e0, e1, fit);
+            const uint8_t* weights = weightTable(spec.indexBits);
+            for (int it = 0; it < iterations && fit.error > 0; ++it)
+            {
+                float aa = 0.0f, ab = 0.0f, bb = 0.0f, ax[4] = {}, bx[4] = {};
+                for (int i = 0; i < 16; ++i)
+                {
+                    if (!(mask & (1u << i)))
+                        continue;
+                    const float b = weights[fit.indices[i]] / 64.0f, a = 1.0f - b;
+                    aa += a * a;
+                    ab += a * b;
+                    bb += b * b;
+                    for (int c = 0; c < n; ++c)
+                    {
+                        ax[c] += a * px[i][c0 + c];
+                        bx[c] += b * px[i][c0 + c];
+                    }
+                }
+                const float det = aa * bb - ab * ab;
+                if (det < 1e-3f)
+                    break;
+                for (int c = 0; c < n; ++c)
+                {
+                    e0[c0 + c] = std::min(255.0f, std::max(0.0f, (bb * ax[c] - ab * bx[c]) / det));
+                    e1[c0 + c] = std::min(255.0f, std::max(0.0f, (aa * bx[c] - ab * ax[c]) / det));
+                }
+                const int before = fit.error;
+                tryBC7Endpoints(px, mask, spec, e0, e1, fit);
+                if (fit.error == before)
+                    break;
+            }
+        }
+
+        // The top index bit of a subset's anchor pixel is not stored, so it has to be 0: when it is not, swapping
+        // the endpoints and mirroring the indices gives the same colors with the anchor's index below half.
+        void fixAnchor(SubsetFit& fit, unsigned mask, int anchor, int indexBits)
+        {
+            const int top = (1 << indexBits) - 1;
+            if (fit.indices[anchor] <= top / 2)
+                return;
+            for (int c = 0; c < 4; ++c)
+                std::swap(fit.q[0][c], fit.q[1][c]);
+            std::swap(fit.p[0], fit.p[1]);
+            for (int i = 0; i < 16; ++i)
+                if (mask & (1u << i))
+                    fit.indices[i] = (uint8_t)(top - fit.indices[i]);
+        }
+
+        // A BC7 block in the making and the squared error of its pixels.
+        struct Bc7Block
+        {
+            int mode, partition, rotation;
+            int q[6][4];
+            int p[6];
+            uint8_t indices[16], indices2[16];
+            int error;
+        };
+
+        // Fits a block of one of modes 1, 3, 5, 6 and 7 with the given partition and rotation. Least squares
+        // refinement runs once for NORMAL and twice for BEST, which also measures every choice of p-bits.
+        void fitBC7Mode(const int px[16][4], int mode, int partition, int rotation, Quality quality, Bc7Block& block)
+        {
+            const int iterations = quality == Quality::FAST ? 0 : quality == Quality::NORMAL ? 1 : 2;
+            const Bc7Mode& m = bc7Modes[mode];
+            block.mode = mode;
+            block.partition = partition;
+            block.rotation = rotation;
+            block.error = 0;
+            memset(block.q, 0, sizeof(block.q));
+
+            int work[16][4];
+            memcpy(work, px, sizeof(work));
+            if (rotation)
+                for (int i = 0; i < 16; ++i)
+                    std::swap(work[i][3], work[i][rotation - 1]);
+
+            uint8_t subsets[16];
+            int anchors[3];
+            partitionOf(m.numSubsets, partition, subsets, anchors);
+            SubsetSpec spec;
+            spec.first = 0;
+            spec.count = (m.alphaBits && !m.indexBits2) ? 4 : 3;
+            spec.bits[0] = spec.bits[1] = spec.bits[2] = m.colorBits;
+            spec.bits[3] = m.alphaBits;
+            spec.pbits = m.endpointPBits ? 1 : m.sharedPBits ? 2 : 0;
+            spec.indexBits = m.indexBits;
+            spec.allPBits = quality == Quality::BEST;
+            for (int s = 0; s < m.numSubsets; ++s)
+            {
+                unsigned mask = 0;
+                bool opaque = true;
+                for (int i = 0; i < 16; ++i)
+                {
+                    if (subsets[i] == s)
+                    {
+                        mask |= 1u << i;
+                        opaque = opaque && work[i][3] == 255;
+                    }
+                }
+                spec.opaque = opaque && spec.count == 4 && spec.pbits;
+                SubsetFit fit;
+                fitSubset(work, mask, spec, iterations, fit);
+                fixAnchor(fit, mask, anchors[s], m.indexBits);
+                for (int e = 0; e < 2; ++e)
+                {
+                    memcpy(block.q[2 * s + e], fit.q[e], sizeof(fit.q[e]));
+                    block.p[2 * s + e] = std::max(0, fit.p[e]);
+                }
+                for (int i = 0; i < 16; ++i)
+                    if (mask & (1u << i))
+                        block.indices[i] = fit.indices[i];
+                block.error += fit.error;
+            }
+
+            if (m.indexBits2)
+            {
+                // modes 4 and 5: alpha has endpoints and indices of its own
+                SubsetSpec alpha = spec;
+                alpha.first = 3;
+                alpha.count = 1;
+                alpha.pbits = 0;
+                alpha.indexBits = m.indexBits2;
+                alpha.opaque = false;
+                SubsetFit fit;
+                fitSubset(work, 0xFFFF, alpha, iterations, fit);
+                fixAnchor(fit, 0xFFFF, 0, m.indexBits2);
+                block.q[0][3] = fit.q[0][3];
+                block.q[1][3] = fit.q[1][3];
+                memcpy(block.indices2, fit.indices, 16);
+                block.error += fit.error;
+            }
+            else if (!m.alphaBits)
+            {
+                for (int i = 0; i < 16; ++i)
+                    block.error += (255 - work[i][3]) * (255 - work[i][3]);
+            }
+        }
+
+        void writeBC7Block(const Bc7Block& block, uint8_t* out)
+        {
+            const Bc7Mode& m = bc7Modes[block.mode];
+            BlockWriter bits;
+            bits.write(1u << block.mode, block.mode + 1);
+            bits.write((unsigned)block.partition, m.partitionBits);
+            bits.write((unsigned)block.rotation, m.rotationBits);
+            bits.write(0, m.indexSelectionBits);
+            const int numEndpoints = 2 * m.numSubsets;
+            for (int c = 0; c < 3; ++c)
+                for (int i = 0; i < numEndpoints; ++i)
+                    bits.write((unsigned)block.q[i][c], m.colorBits);
+            for (int i = 0; i < numEndpoints; ++i)
+                bits.write((unsigned)block.q[i][3], m.alphaBits);
+            if (m.endpointPBits)
+            {
+                for (int i = 0; i < numEndpoints; ++i)
+                    bits.write((unsigned)block.p[i], 1);
+            }
+            else if (m.sharedPBits)
+            {
+                for (int s = 0; s < m.numSubsets; ++s)
+                    bits.write((unsigned)block.p[2 * s], 1);
+            }
+            uint8_t subsets[16];
+            int anchors[3];
+            partitionOf(m.numSubsets, block.partition, subsets, anchors);
+            for (int i = 0; i < 16; ++i)
+            {
+                const bool anchor = i == anchors[0] || i == anchors[1] || i == anchors[2];
+                bits.write(block.indices[i], m.indexBits - (anchor ? 1 : 0));
+            }
+            if (m.indexBits2)
+            {
+                for (int i = 0; i < 16; ++i)
+                    bits.write(block.indices2[i], m.indexBits2 - (i == 0 ? 1 : 0));
+            }
+            bits.store(out);
+        }
+
+        // Squared distance of the pixels whose channel sums and sums of products of channels are in sums to
+        // their principal axis: the trace of their scatter matrix less its largest eigenvalue. The eigenvalue is
+        // estimated from two steps of power iteration, starting from the column of the channel that varies most.
+        // N is 3 for opaque pixels, whose alpha adds nothing.
+        template <int N>
+        float lineError(const int sums[16], int n)
+        {
+            const float inverse = 1.0f / n;
+            float scatter[N][N], trace = 0.0f;
+            int k = 4, widest = 0;
+            for (int a = 0; a < N; ++a)
+            {
+                for (int b = a; b < N; ++b)
+                    scatter[a][b] = scatter[b][a] = sums[k + b - a] - (float)sums[a] * sums[b] * inverse;
+                k += 4 - a;
+                trace += scatter[a][a];
+                if (scatter[a][a] > scatter[widest][widest])
+                    widest = a;
+            }
+            float v1[N], v2[N], vv = 0.0f, vSv = 0.0f;
+            for (int a = 0; a < N; ++a)
+            {
+                v1[a] = 0.0f;
+                for (int b = 0; b < N; ++b)
+                    v1[a] += scatter[a][b] * scatter[b][widest];
+                vv += v1[a] * v1[a];
+            }
+            for (int a = 0; a < N; ++a)
+            {
+                v2[a] = 0.0f;
+                for (int b = 0; b < N; ++b)
+                    v2[a] += scatter[a][b] * v1[b];
+                vSv += v1[a] * v2[a];
+            }
+            return vv == 0.0f ? trace : trace - vSv / vv;
+        }
+
+        // The count 2 subset partitions that suit the block best, best first, going by how far the pixels of each
+        // subset are from their principal axis. That is estimated from sums over the pixels, as fitting every
+        // partition would cost far more than the fit of the few that are kept.
+        void rankPartitions(const int px[16][4], bool opaque, int count, int ranked[])
+        {
+            // the 4 channels of each pixel and their 10 products, summed over a subset by one pass over the pixels
+            int moments[16][16] = {}, total[16] = {};
+            for (int i = 0; i < 16; ++i)
+            {
+                int k = 0;
+                for (int a = 0; a < 4; ++a)
+                    moments[i][k++] = px[i][a];
+                for (int a = 0; a < 4; ++a)
+                    for (int b = a; b < 4; ++b)
+                        moments[i][k++] = px[i][a] * px[i][b];
+                for (k = 0; k < 16; ++k)
+                    total[k] += moments[i][k];
+            }
+
+            // The pixels of the smaller subset of each partition, the one summed; the other is what is left.
+            struct SmallerSubsets
+            {
+                uint8_t pixels[64][8];
+                uint8_t count[64];
+
+                SmallerSubsets()
+                {
+                    for (int partition = 0; partition < 64; ++partition)
+                    {
+                        unsigned mask = partitions2[partition];
+                        int n = 0;
+                        for (int i = 0; i < 16; ++i)
+                            n += (mask >> i) & 1;
+                        if (n > 8)
+                            mask = ~mask & 0xFFFF;
+                        count[partition] = 0;
+                        for (int i = 0; i < 16; ++i)
+                            if (mask & (1u << i))
+                                pixels[partition][count[partition]++] = (uint8_t)i;
+                    }
+                }
+            };
+            static const SmallerSubsets smaller;
+
+            std::pair<float, int> scores[64];
+            for (int partition = 0; partition < 64; ++partition)
+            {
+                const int n = smaller.count[partition];
+                int sums[16] = {}, rest[16];
+                for (int j = 0; j < n; ++j)
+                {
+                    const int* m = moments[smaller.pixels[partition][j]];
+                    for (int k = 0; k < 16; ++k)
+                        sums[k] += m[k];
+                }
+                for (int k = 0; k < 16; ++k)
+                    rest[k] = total[k] - sums[k];
+                const float error = opaque ? lineError<3>(sums, n) + lineError<3>(rest, 16 - n) :
+                    lineError<4>(sums, n) + lineError<4>(rest, 16 - n);
+                scores[partition] = std::make_pair(error, partition);
+            }
+            std::partial_sort(scores, scores + count, scores + 64);
+            for (int i = 0; i < count; ++i)
+                ranked[i] = scores[i].second;
+        }
+
+        // Writes the 16 bytes of a BC7 block. FAST only tries mode 6, one subset of RGBA with 4-bit indices.
+        // NORMAL adds modes 1 and 3 with the 2 partitions rankPartitions() likes best for opaque blocks, and mode 5,
+        // which keeps alpha apart, for the others. BEST refines more and widens the search to 8 partitions, the
+        // rotations of mode 5 and mode 7's partitions of RGBA.
+        void encodeBC7(const uint8_t block[16][4], Quality quality, uint8_t* out)
+        {
+            int px[16][4];
+            bool opaque = true;
+            for (int i = 0; i < 16; ++i)
+            {
+                for (int c = 0; c < 4; ++c)
+                    px[i][c] = block[i][c];
+                opaque = opaque && block[i][3] == 255;
+            }
+
+            Bc7Block best, candidate;
+            fitBC7Mode(px, 6, 0, 0, quality, best);
+            auto tryMode = [&](int mode, int partition, int rotation) {
+                if (best.error == 0)
+                    return;
+                fitBC7Mode(px, mode, partition, rotation, quality, candidate);
+                if (candidate.error < best.error)
+                    best = candidate;
+            };
+            if (quality != Quality::FAST)
+            {
+                int ranked[8];
+                const int count = quality == Quality::BEST ? 8 : 2;
+                if (opaque)
+                {
+                    rankPartitions(px, true, count, ranked);
+                    for (int i = 0; i < count; ++i)
+                    {
+                        tryMode(1, ranked[i], 0);
+                        tryMode(3, ranked[i], 0);
+                    }
+                }
+                else
+                {
+                    tryMode(5, 0, 0);
+                    if (quality == Quality::BEST)
+                    {
+                        for (int rotation = 1; rotation < 4; ++rotation)
+                            tryMode(5, 0, rotation);
+                        rankPartitions(px, false, count, ranked);
+                        for (int i = 0; i < count; ++i)
+                            tryMode(7, ranked[i], 0);
+                    }
+                }
+            }
+            writeBC7Block(best, out);
+        }
+
+        // Compresses the blocks of rows of blocks [by0, by1).
+        template <void (*encodeBlock)(const uint8_t[16][4], Quality, uint8_t*), int B>
+        void encodeBlockRows(const uint8_t* pixels, int w, int h, int channels, Quality quality, int by0, int by1, uint8_t* blocks)
+        {
+            const int bw = (w + 3) / 4;
+            uint8_t block[16][4];
+            for (int by = by0; by < by1; ++by)
+            {
+                uint8_t* dst = blocks + (size_t)by * bw * B;
+                for (int bx = 0; bx < bw; ++bx)
+                {
+                    loadBlock(pixels, w, h, channels, bx, by, block);
+                    encodeBlock(block, quality, dst + (size_t)bx * B);
+                }
+            }
+        }
+
+        template <void (*encodeBlock)(const uint8_t[16][4], Quality, uint8_t*), int B>
+        void encodeSurface(const uint8_t* pixels, int w, int h, int channels, Quality quality, uint8_t* blocks, unsigned numThreads)
+        {
+            const int bw = (w + 3) / 4;
+            const int bh = (h + 3) / 4;
+            // Encoding costs far more per block than decoding, and BC7 blocks far more than BC1, so bands are
+            // smaller than decodeSurface()'s to leave enough of them to even out blocks of different cost.
+            const int band = std::max(1, 256 / bw);
+            const size_t numBands = ((size_t)bh + band - 1) / band;
+            ImageCodecs::ThreadPool::global().parallelFor(0, numBands, [&](size_t i) {
+                const int by0 = (int)i * band;
+                encodeBlockRows<encodeBlock, B>(pixels, w, h, channels, quality, by0, std::min(bh, by0 + band), blocks);
+            }, numThreads);
+        }
+    }
+
+    size_t blockBytes(Format format)
+    {
+        return (format == Format::BC1 || format == Format::BC4 || format == Format::BC4_SNORM) ? 8 : 16;
+    }
+
+    bool isFloat(Format format)
+    {
+        return format == Format::BC6H_UF16 || format == Format::BC6H_SF16;
+    }
+
+    size_t surfaceBytes(Format format, int w, int h)
+    {
+        return (size_t)((w + 3) / 4) * (size_t)((h + 3) / 4) * blockBytes(format);
+    }
+
+    int channels(Format format)
+    {
+        switch (format)
+        {
+        case Format::BC4:
+        case Format::BC4_SNORM:
+            return 1;
+        case Format::BC5:
+        case Format::BC5_SNORM:
+        case Format::BC6H_UF16:
+        case Format::BC6H_SF16:
+            return 3;
+        default:
+            return 4;
+        }
+    }
+
+    bool decode(Format format, const uint8_t* blocks, size_t size, int w, int h, uint8_t* pixels, unsigned numThreads)
+    {
+        if (w <= 0 || h <= 0 || size < surfaceBytes(format, w, h))
+            return false;
+        switch (format)
+        {
+        case Format::BC1:
+            decodeSurface<decodeBC1, 4, 8>(blocks, w, h, pixels, numThreads);
+            break;
+        case Format::BC2:
+            decodeSurface<decodeBC2, 4, 16>(blocks, w, h, pixels, numThreads);
+            break;
+        case Format::BC3:
+            decodeSurface<decodeBC3, 4, 16>(blocks, w, h, pixels, numThreads);
+            break;
+        case Format::BC4:
+            decodeSurface<decodeBC4<false>, 1, 8>(blocks, w, h, pixels, numThreads);
+            break;
+        case Format::BC4_SNORM:
+            decodeSurface<decodeBC4<true>, 1, 8>(blocks, w, h, pixels, numThreads);
+            break;
+        case Format::BC5:
+            decodeSurface<decodeBC5<false>, 3, 16>(blocks, w, h, pixels, numThreads);
+            break;
+        case Format::BC5_SNORM:
+            decodeSurface<decodeBC5<true>, 3, 16>(blocks, w, h, pixels, numThreads);
+            break;
+        case Format::BC6H_UF16:
+            decodeSurface<decodeBC6H<false>, 3 * sizeof(float), 16>(blocks, w, h, pixels, numThreads);
+            break;
+        case Format::BC6H_SF16:
+            decodeSurface<decodeBC6H<true>, 3 * sizeof(float), 16>(blocks, w, h, pixels, numThreads);
+            break;
+        case Format::BC7:
+            decodeSurface<decodeBC7, 4, 16>(blocks, w, h, pixels, numThreads);
+            break;
+        default:
+            return false;
+        }
+        return true;
+    }
+
+    bool encode(Format format, const uint8_t* pixels, int w, int h, int channels, uint8_t* blocks, Quality quality, unsigned numThreads)
+    {
+        if (w <= 0 || h <= 0 || channels < 1 || channels > 4)
+            return false;
+        switch (format)
+        {
+        case Format::BC1:
+            encodeSurface<encodeBC1, 8>(pixels, w, h, channels, quality, blocks, numThreads);
+            break;
+        case Format::BC3:
+            encodeSurface<encodeBC3, 16>(pixels, w, h, channels, quality, blocks, numThreads);
+            break;
+        case Format::BC7:
+            encodeSurface<encodeBC7, 16>(pixels, w, h, channels, quality, blocks, numThreads);
+            break;
+        default:
+            return false;
+        }
+        return true;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace bcn
+{
+    // Block compressed texture formats, as stored in DDS files. Each block holds 4x4 pixels.
+    enum class Format
+    {
+        BC1,       // DXT1: RGB, or RGB with 1-bit alpha
+        BC2,       // DXT3: RGB with explicit 4-bit alpha
+        BC3,       // DXT5: RGB with interpolated alpha
+        BC4,       // ATI1: one channel
+        BC4_SNORM,
+        BC5,       // ATI2: two channels, mostly normal maps
+        BC5_SNORM,
+        BC6H_UF16, // HDR RGB as half floats
+        BC6H_SF16,
+        BC7        // RGBA, with a choice of 8 modes per block
+    };
+
+    // Bytes per 4x4 block: 8 for BC1 and BC4, 16 for the others.
+    size_t blockBytes(Format format);
+    // Bytes of a w x h surface, with the last row and column of blocks only partly covered when w or h are not
+    // multiples of 4.
+    size_t surfaceBytes(Format format, int w, int h);
+    // Channels of the pixels decode() gives: 4 (RGBA) for BC1 to BC3 and BC7, 1 for BC4, 3 for BC5, whose blue is 0
+    // as a GPU samples it, and 3 (RGB) for BC6H.
+    int channels(Format format);
+    // True for BC6H, which decode() expands to 32-bit floats rather than bytes.
+    bool isFloat(Format format);
+
+    // Expands the blocks of a w x h surface to pixels of channels(format) channels, bytes or floats as isFloat() says,
+    // rows top to bottom as the blocks are stored. SNORM values -1 to 1 are mapped to 0 to 255, and blocks of the
+    // reserved BC6H and BC7 modes decode to black. Rows of blocks are decoded on numThreads threads of the shared
+    // pool, 0 for the whole pool. Returns false when size is less than surfaceBytes().
+    bool decode(Format format, const uint8_t* blocks, size_t size, int w, int h, uint8_t* pixels, unsigned numThreads = 0);
+
+    // How hard encode() searches for the endpoints and, for BC7, the modes of each block.
+    enum class Quality
+    {
+        FAST,   // endpoints from the bounding box of the colors (BC1, BC3) or one mode (BC7)
+        NORMAL, // endpoints along the principal axis of the colors, refined by least squares; a few BC7 partitions
+        BEST    // more refinement, and a wider search of endpoints, modes and partitions
+    };
+
+    // Compresses w x h pixels of channels (1 to 4) bytes, rows top to bottom, into the surfaceBytes() of blocks of a
+    // BC1, BC3 or BC7 surface. Gray is spread to RGB and images without alpha are opaque; BC1 stores pixels whose
+    // alpha is below 128 as transparent black. Rows of blocks are compressed on numThreads threads of the shared
+    // pool, 0 for the whole pool. Returns false for the other formats.
+    bool encode(Format format, const uint8_t* pixels, int w, int h, int channels, uint8_t* blocks,
+        Quality quality = Quality::NORMAL, unsigned numThreads = 0);
+}
\ No newline at end of file
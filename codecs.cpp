@@ -1,1748 +1,2584 @@
-#include "codecs.h"
-#include <algorithm>
-#include <cstdint>
-#include <exception>
-#include <fstream>
-#include <filesystem>
-#include <iostream>
-
-#include "gif.h"
-
-#define TJE_IMPLEMENTATION
-#include "jpeg_enc.h"
-#include "jpeg_dec.h"
-
-#define NV_DDS_NO_GL_SUPPORT
-#include "nv_dds.h"
-
-#include "png.h"
-#include "png_encoder.h"
-
-#include "pnm.h"
-
-extern "C" {
-	#include <tiffio.h>
-}
-
-#define TINYEXR_IMPLEMENTATION
-#define TINYEXR_USE_MINIZ 1
-#include "tinyexr.h"
-
-// required libs
-#pragma comment(lib, "jpeg.lib")
-#pragma comment(lib, "lzma.lib")
-#pragma comment(lib, "miniz.lib")
-#pragma comment(lib, "libwebp.lib")
-#ifdef NDEBUG
-#pragma comment(lib, "zlib.lib")
-#pragma comment(lib, "libpng16.lib")
-#pragma comment(lib, "tiff.lib")
-#else
-#pragma comment(lib, "zlibd.lib")
-#pragma comment(lib, "libpng16d.lib")
-#pragma comment(lib, "tiffd.lib")
-#endif
-
-#include <libpng16/png.h>
-
-#include <webp/encode.h>
-#include <webp/decode.h>
-
-namespace ImageCodecs
-{
-	void Image::read(std::string filepath)
-	{
-		auto ext = std::filesystem::path(filepath).extension().string();
-		for (auto& c : ext)
-			c = std::tolower(c);
-		if (ext == ".bmp")
-			readBmp(filepath, &pixels_, w_, h_, d_,type_);
-		else if (ext == ".dds")
-			readDds(filepath, &pixels_, w_, h_, d_, type_);
-		else if (ext == ".exr")
-			readExr(filepath, &pixels_, w_, h_, d_, type_);
-		else if (ext == ".gif")
-			readGif(filepath, &pixels_, w_, h_, d_, type_);
-		else if (ext == ".hdr")
-			readHdr(filepath, &pixels_, w_, h_, d_, type_);
-		else if (ext == ".jpg" || ext == ".jpeg")
-			readJpg(filepath, &pixels_, w_, h_, d_, type_);
-		else if (ext == ".png")
-			readPng(filepath, &pixels_, w_, h_, d_, type_);
-		else if (ext == ".pbm" || ext == ".pfm" || ext == ".pgm" || ext == ".pnm" || ext == ".ppm")
-			readPbm(filepath, &pixels_, w_, h_, d_, type_);
-		else if (ext == ".tga")
-			readTga(filepath, &pixels_, w_, h_, d_, type_);
-		else if (ext == ".tif" || ext == ".tiff")
-			readTiff(filepath, &pixels_, w_, h_, d_, type_);
-		else if (ext == ".webp")
-			readWebp(filepath, &pixels_, w_, h_, d_, type_);
-		else
-		{
-			throw std::invalid_argument("Cannot parse filetype");
-		}
-
-		if (pixels_ == nullptr)
-		{
-			throw std::exception("Could not read image data");
-		}
-	}
-
-	void Image::write(std::string filepath)
-	{
-		auto ext = std::filesystem::path(filepath).extension().string();
-		for (auto& c : ext)
-			c = std::tolower(c);
-		if (ext == ".bmp")
-			writeBmp(filepath, pixels_, w_, h_, d_, type_);
-		else if (ext == ".dds")
-			writeDds(filepath, pixels_, w_, h_, d_, type_);
-		else if (ext == ".exr")
-			writeExr(filepath, pixels_, w_, h_, d_, type_);
-		else if (ext == ".gif")
-			writeGif(filepath, pixels_, w_, h_, d_, type_);
-		else if (ext == ".hdr")
-			writeHdr(filepath, pixels_, w_, h_, d_, type_);
-		else if (ext == ".jpg" || ext == ".jpeg")
-			writeJpg(filepath, pixels_, w_, h_, d_, type_);
-		else if (ext == ".png")
-			writePng(filepath, pixels_, w_, h_, d_, type_);
-		else if (ext == ".pbm" || ext == ".pfm" || ext == ".pgm" || ext == ".pnm" || ext == ".ppm")
-			writePbm(filepath, pixels_, w_, h_, d_, type_);
-		else if (ext == ".tga")
-			writeTga(filepath, pixels_, w_, h_, d_, type_);
-		else if (ext == ".tiff" || ext == ".tif")
-			writeTiff(filepath, pixels_, w_, h_, d_, type_);
-		else if (ext == ".webp")
-			writeWebp(filepath, pixels_, w_, h_, d_, type_);
-		else
-		{
-			throw std::invalid_argument("Cannot parse filetype");
-		}
-	}
-
-	void Image::transpose(unsigned char* pixels, const int w, const int h, const int d, const Type& type)
-	{
-		unsigned int byteSz = byteSize(type);
-		unsigned char* tempPix = new unsigned char[totalBytes()];
-
-		// Copy pixels in reverse order.
-		for (unsigned int i = 0; i < h; ++i)
-		{
-			for (unsigned int j = 0; j < w; ++j)
-			{
-				for (unsigned int k = 0; k < d * byteSz; k += byteSz)
-				{
-					unsigned int r = i * w * d * byteSz;
-					unsigned int c = j * d * byteSz;
-					unsigned int r2 = j * h * d * byteSz;
-					unsigned int c2 = i * d * byteSz;
-
-					if (type == Type::FLOAT)
-					{
-						memcpy(&tempPix[r + c + k], &pixels[r2 + c2 + k], FLOAT_SIZE);
-					}
-					else
-					{
-						tempPix[r + c + k] = pixels[r2 + c2 + k];
-					}
-				}
-			}
-		}
-
-		// Now copy back over to original array.
-		for (unsigned int i = 0; i < totalBytes(); ++i)
-		{
-			pixels[i] = tempPix[i];
-		}
-		delete[] tempPix;
-	}
-
-
-	void Image::flip(unsigned char* pixels, const int w, const int h, const int d, const Type& type)
-	{
-		auto byteSz = byteSize();
-		unsigned char* tempPix = new unsigned char[totalBytes()];
-
-		// Copy pixels in reverse order.
-		for (unsigned int i = 0; i < h; ++i)
-		{
-			for (unsigned int j = 0; j < w; ++j)
-			{
-				for (unsigned int k = 0; k < d * byteSz; k += byteSz)
-				{
-					unsigned int r = i * w * d * byteSz;
-					unsigned int r_inv = (h - 1 - i) * w * d * byteSz;
-					unsigned int c = j * d * byteSz;
-
-					if (type == Type::FLOAT)
-					{
-						memcpy(&tempPix[r + c + k], &pixels[r_inv + c + k], FLOAT_SIZE);
-					}
-					else
-					{
-						tempPix[r + c + k] = pixels[r_inv + c + k];
-					}
-				}
-			}
-		}
-
-		// Now copy back over to original array.
-		for (unsigned int i = 0; i < totalBytes(); ++i)
-		{
-			pixels[i] = tempPix[i];
-		}
-		delete[] tempPix;
-	}
-
-	void Image::swapBR(unsigned char* pixels, const int w, const int h, const int d, const Type& type)
-	{
-		unsigned int byteSz = byteSize(type);
-		unsigned char* tempPix = new unsigned char[totalBytes()];
-
-		// Copy pixels in reverse order.
-		for (unsigned int i = 0; i < h; ++i)
-		{
-			for (unsigned int j = 0; j < w; ++j)
-			{
-				for (unsigned int k = 0; k < d * byteSz; k += byteSz)
-				{
-					unsigned int r = i * w * d * byteSz;
-					unsigned int c = j * d * byteSz;
-
-					if (type == Type::FLOAT)
-					{
-						if (k == 0)
-						{
-							memcpy(&tempPix[r + c + 0], &pixels[r + c + 2], FLOAT_SIZE);
-						}
-						else if (k == 2)
-						{
-							memcpy(&tempPix[r + c + 2], &pixels[r + c + 0], FLOAT_SIZE);
-						}
-						else {
-							memcpy(&tempPix[r + c + k], &pixels[r + c + k], FLOAT_SIZE);
-						}
-					}
-					else
-					{
-						if (k == 0)
-						{
-							tempPix[r + c + 0] = pixels[r + c + 2];
-						}
-						else if (k == 2)
-						{
-							tempPix[r + c + 2] = pixels[r + c + 0];
-						}
-						else {
-							tempPix[r + c + k] = pixels[r + c + k];
-						}
-					}
-				}
-			}
-		}
-
-		// Now copy back over to original array.
-		for (unsigned int i = 0; i < totalBytes(); ++i)
-		{
-			pixels[i] = tempPix[i];
-		}
-		delete[] tempPix;
-	}
-
-	// Adapted from: https://github.com/marc-q/libbmp/blob/master/CPP/libbmp.cpp
-	// NOTE: handles only 3 channel RGB .bmp files with 'BITMAPINFOHEADER' format
-	void Image::readBmp(std::string filepath, unsigned char** pixels, int& w, int& h, int& d, Type& type)
-	{
-		const uint32_t BMP_MAGIC = 19778;
-		struct {
-			unsigned int bfSize = 0;
-			unsigned int bfReserved = 0;
-			unsigned int bfOffBits = 54;
-			unsigned int biSize = 40;
-			int biWidth = 0;
-			int biHeight = 0;
-			unsigned short biPlanes = 1;
-			unsigned short biBitCount = 24;
-			unsigned int biCompression = 0;
-			unsigned int biSizeImage = 0;
-			int biXPelsPerMeter = 0;
-			int biYPelsPerMeter = 0;
-			unsigned int biClrUsed = 0;
-			unsigned int biClrImportant = 0;
-		} header;
-
-		struct {
-			size_t len_row;
-			size_t len_pixel = 3;
-		} bmpPixBuf;
-
-		std::ifstream f_img(filepath.c_str(), std::ios::binary);
-		if (!f_img.is_open())
-			throw std::exception("Could not open .bmp file");
-
-		// Check if its an bmp file by comparing the magic nbr
-		unsigned short magic;
-		f_img.read(reinterpret_cast<char*>(&magic), sizeof(magic));
-
-		if (magic != BMP_MAGIC)
-		{
-			f_img.close();
-			throw std::exception("Could not parse .bmp file");
-		}
-
-		// Read the header structure into header
-		f_img.read(reinterpret_cast<char*>(&header), sizeof(header));
-
-		// Select the mode (bottom-up or top-down)
-		h = std::abs(header.biHeight);
-		const int offset = (header.biHeight > 0 ? 0 : h - 1);
-		const int padding = (header.biWidth % 4);
-
-		// Allocate the pixel buffer		
-		bmpPixBuf.len_row = header.biWidth * bmpPixBuf.len_pixel;
-		*pixels = new unsigned char[h * bmpPixBuf.len_row];		
-
-		for (int y = h - 1; y >= 0; y--)
-		{
-			// Read a whole row of pixels from the file
-			f_img.read(reinterpret_cast<char*> (&(*pixels)[(int)std::abs(y - offset) * bmpPixBuf.len_row]), bmpPixBuf.len_row);
-
-			// Skip the padding
-			f_img.seekg(padding, std::ios::cur);
-		}
-
-		h = header.biHeight;
-		w = header.biWidth;
-		d = 3;
-
-		f_img.close();
-	}
-
-	// Adapted from: https://github.com/marc-q/libbmp/blob/master/CPP/libbmp.cpp
-	// NOTE: handles only 3 channel RGB .bmp files with 'BITMAPINFOHEADER' format
-	void Image::writeBmp(std::string filepath, unsigned char* pixels, int& w, int& h, int& d, Type& type)
-	{
-		const uint32_t BMP_MAGIC = 19778;
-		struct {
-			unsigned int bfSize = 0;
-			unsigned int bfReserved = 0;
-			unsigned int bfOffBits = 54;
-			unsigned int biSize = 40;
-			int biWidth = 0;
-			int biHeight = 0;
-			unsigned short biPlanes = 1;
-			unsigned short biBitCount = 24;
-			unsigned int biCompression = 0;
-			unsigned int biSizeImage = 0;
-			int biXPelsPerMeter = 0;
-			int biYPelsPerMeter = 0;
-			unsigned int biClrUsed = 0;
-			unsigned int biClrImportant = 0;
-		} header;
-
-		header.bfSize = (3 * w + (w % 4)) * h;
-		header.biWidth = w;
-		header.biHeight = h;
-
-		// Open the image file in binary mode
-		std::ofstream f_img(filepath.c_str(), std::ios::binary);
-
-		if (!f_img.is_open())
-			throw std::exception("Could not open .bmp file to write");
-
-		// Since an adress must be passed to fwrite, create a variable!
-		const unsigned short magic = BMP_MAGIC;
-
-		f_img.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
-		f_img.write(reinterpret_cast<const char*>(&header), sizeof(header));
-
-		// Select the mode (bottom-up or top-down)
-		const int offset = (header.biHeight > 0 ? 0 : h - 1);
-		const int padding = header.biWidth % 4;
-
-		for (int y = h - 1; y >= 0; y--)
-		{
-			// Write a whole row of pixels into the file
-			uint32_t len_row = w * d;
-			f_img.write(reinterpret_cast<char*> (&pixels[(int)std::abs(y - offset) * len_row]), len_row);
-
-			// Write the padding
-			f_img.write("\0\0\0", padding);
-		}
-
-		f_img.close();
-	}
-
-	void Image::readDds(std::string filepath, unsigned char** pixels, int& w, int& h, int& d, Type& type)
-	{
-		nv_dds::CDDSImage image;
-		nv_dds::CSurface surf;
-		int totalBytes_ = 0;
-		try
-		{
-			image.load(filepath, true);
-		}
-		catch (std::exception e1)
-		{
-			throw std::exception(e1.what());
-		}
-
-		w = image.get_width();
-		h = image.get_height();
-		d = image.get_components();
-		totalBytes_ = image.get_size();
-
-		if (image.get_num_mipmaps() > 1) {
-			surf = image.get_mipmap(0);
-			w = surf.get_width();
-			h = surf.get_height();
-			d = surf.get_depth();
-			totalBytes_ = surf.get_size();
-		}
-
-		switch (image.get_type()) {
-		case nv_dds::TextureType::TextureFlat:
-			break;
-		case nv_dds::TextureType::TextureCubemap:
-			throw std::exception("Cannot handle .dds cubemap textures");
-		case nv_dds::TextureType::Texture3D:
-			throw std::exception("Cannot handle .dds 3D textures");
-		}
-
-		if (totalBytes_ / (w * h * d) != 1)
-		{
-			if (totalBytes_ / (w * h * d) == 4)
-			{
-				type = Type::FLOAT;
-			}
-			else if (totalBytes_ / (w * h * d) == 2)
-			{
-				type = Type::USHORT;
-			}
-		}
-
-		*pixels = new unsigned char[totalBytes()];
-		unsigned int byte_counter = 0;		
-		if (image.get_num_mipmaps() > 1) 
-		{
-			memcpy(*pixels, surf, totalBytes());
-		}
-		else
-		{			
-			memcpy(*pixels, image, totalBytes());
-		}
-
-		flip(*pixels, w, h, d, type);
-
-		surf.clear();
-		image.clear();		
-	}
-	void Image::writeDds(std::string filepath, unsigned char* pixels, int& w, int& h, int& d, Type& type)
-	{
-		nv_dds::CTexture img;
-		img.create(w,h,1,totalBytes(),pixels);	
-		nv_dds::CDDSImage ddsimage;		
-		unsigned int fmt = 0;
-		switch (d) {
-		case 1:
-			fmt = 6403;//GL_RED
-			break;
-		case 3:
-			fmt = GL_RGB;
-			break;
-		case 4:
-			fmt = GL_RGBA;
-			break;
-		}
-		ddsimage.create_textureFlat(fmt, d, img);		
-		ddsimage.save(filepath);
-		img.clear();
-		ddsimage.clear();
-	}
-
-	void Image::readExr(std::string filepath, unsigned char** pixels, int& w, int& h, int& d, Type& type)
-	{
-		std::vector<unsigned char> loadedData;
-		std::ifstream ifile(filepath.c_str(), std::ios::in | std::ios::binary);
-		while (ifile.good())
-		{
-			loadedData.push_back(ifile.get());
-		}
-		ifile.close();
-		float* floatPixels;
-		const char* err = "\0";
-		auto ret = LoadEXRFromMemory(&floatPixels, &w, &h, loadedData.data(), loadedData.size(), &err);
-		loadedData.clear();
-		if (!ret)
-		{
-			type = Type::FLOAT;
-			d = 4; // assume RGBA float data
-			unsigned int sz = totalBytes();
-			*pixels = new unsigned char[sz];
-			memcpy(*pixels, floatPixels, sz);
-		}
-		else
-		{
-			std::cerr << err << std::endl;
-			FreeEXRErrorMessage(err);
-			throw std::exception("Could not load .exr");
-		}
-		type = Type::FLOAT;
-		delete[] floatPixels;
-	}
-
-	void Image::writeExr(std::string filepath, unsigned char* pixels, int& w, int& h, int& d, Type& type)
-	{
-		const char* err = "\0";
-		float* float_pixels = new float[w * h * d];
-		memcpy(float_pixels, pixels, w * h * d * FLOAT_SIZE);
-		auto ret = SaveEXR(float_pixels, w, h, d, false, filepath.c_str(), &err);
-		if (ret)
-		{
-			std::cerr << err << std::endl;
-		}
-	}
-
-	void Image::readGif(std::string filepath, unsigned char** pixels, int& w, int& h, int& d, Type& type)
-	{
-		gif::gd_GIF* gif;
-		gif = gif::gd_open_gif(filepath.c_str());
-		if (!gif) {
-			throw std::exception("Could not open gif file");
-		}
-
-		w = gif->width;
-		h = gif->height;
-		d = 3; // Assumes 3-channel RGB encoding of data, which is standard for .gif images.
-
-		uint8_t* frame = new uint8_t[totalBytes()];
-
-		switch (gif->depth)
-		{
-		case 16:
-			type = Type::USHORT;
-			break;
-		case 32:
-			type = Type::FLOAT;
-			break;
-		default:
-			type = Type::UBYTE;
-			break;
-		}
-
-		*pixels = new unsigned char[totalBytes()];
-		unsigned int counter = 0;
-
-		// Get only the first frame of the .gif file, although this could be called repeatedly to get all of them.
-		if (gd_get_frame(gif) == -1)
-			throw std::exception("Could not load .gif data");
-		gd_render_frame(gif, frame);
-		memcpy(*pixels, frame, totalBytes());		
-	}
-
-	void Image::writeGif(std::string filepath, unsigned char* pixels, int& w, int& h, int& d, Type& type)
-	{
-		gif::CGIF* pGIF;			
-		gif::CGIF_Config gConfig;    
-		memset(&gConfig, 0, sizeof(gif::CGIF_Config));
-		gif::CGIF_FrameConfig fConfig;
-		memset(&fConfig, 0, sizeof(gif::CGIF_FrameConfig));
-
-		// Assumes 3-channel RGB encoding of data.
-		uint8_t colTable[256*3]; // generate a 3 channel 8-bit global color palette for use.
-		unsigned int counter = 0;
-		for (unsigned int i = 0; i < 3; ++i)
-			for (unsigned int j = 0; j < 256; ++j)
-			{
-				colTable[counter] = j;
-				counter++;
-			}
-		gConfig.width = w;
-		gConfig.height = h;
-		gConfig.numGlobalPaletteEntries = 256;
-		gConfig.pGlobalPalette = colTable;
-		gConfig.path = filepath.c_str();
-
-		// add frame to GIF
-		pGIF = cgif_newgif(&gConfig);	
-		uint8_t* px = new uint8_t[totalBytes()];
-		
-		// Organize pixel data so that each channel is written one-at-a-time.
-		counter = 0;
-		for(unsigned int k = 0; k < d; ++k)
-			for (unsigned int i = 0; i < h; ++i)
-				for (unsigned int j = 0; j < w; ++j)
-					for (unsigned int l = 0; l < byteSize(); ++l)
-					{
-						px[counter] = pixels[i * (w*d*byteSize()) + j * (d * byteSize()) + k * byteSize() + l];
-						counter++;
-					}
-
-		fConfig.pImageData = px;
-		fConfig.delay = 0;
-		auto err = cgif_addframe(pGIF, &fConfig);
-		if (err) // add a new frame to the GIF
-		{
-			delete[] px;			
-			throw std::exception(("Could not assign frame data. Code: " + std::to_string(err)).c_str());
-		}		
-
-		// close GIF and free allocated space
-		cgif_close(pGIF);
-		delete[] px;
-	}
-
-	typedef unsigned char RGBE[4];
-#define R			0
-#define G			1
-#define B			2
-#define E			3
-
-#define  MINELEN	8				// minimum scanline length for encoding
-#define  MAXELEN	0x7fff			// maximum scanline length for encoding
-	int invConvertComponent(int expo, float val)
-	{
-		float d = (float)pow(0.5f, float(expo));
-		return unsigned char(val * 256.0f * d);
-	}
-
-	float convertComponent(int expo, int val)
-	{
-		float v = val / 256.0f;
-		float d = (float)pow(2, expo);
-		return v * d;
-	}
-
-	void workOnRGBE(RGBE* scan, int len, float* cols)
-	{
-		while (len-- > 0) {
-			int expo = scan[0][E] - 128;
-			cols[0] = convertComponent(expo, scan[0][R]);
-			cols[1] = convertComponent(expo, scan[0][G]);
-			cols[2] = convertComponent(expo, scan[0][B]);
-			cols[3] = float(scan[0][E]);
-			cols += 4;
-			scan++;
-		}
-	}
-
-	bool oldDecrunchHDR(RGBE* scanline, int len, FILE* file)
-	{
-		int i;
-		int rshift = 0;
-
-		while (len > 0) {
-			scanline[0][R] = fgetc(file);
-			scanline[0][G] = fgetc(file);
-			scanline[0][B] = fgetc(file);
-			scanline[0][E] = fgetc(file);
-			if (feof(file))
-				return false;
-
-			if (scanline[0][R] == 1 &&
-				scanline[0][G] == 1 &&
-				scanline[0][B] == 1) {
-				for (i = scanline[0][E] << rshift; i > 0; i--) {
-					memcpy(&scanline[0][0], &scanline[-1][0], 4);
-					scanline++;
-					len--;
-				}
-				rshift += 8;
-			}
-			else {
-				scanline++;
-				len--;
-				rshift = 0;
-			}
-		}
-		return true;
-	}
-
-	bool decrunchHDR(RGBE* scanline, int len, FILE* file)
-	{
-		int  i, j;
-
-		if (len < MINELEN || len > MAXELEN)
-			return oldDecrunchHDR(scanline, len, file);
-
-		i = fgetc(file);
-		if (i != 2) {
-			fseek(file, -1, SEEK_CUR);
-			return oldDecrunchHDR(scanline, len, file);
-		}
-
-		scanline[0][G] = fgetc(file);
-		scanline[0][B] = fgetc(file);
-		i = fgetc(file);
-
-		if (scanline[0][G] != 2 || scanline[0][B] & 128) {
-			scanline[0][R] = 2;
-			scanline[0][E] = i;
-			return oldDecrunchHDR(scanline + 1, len - 1, file);
-		}
-
-		// read each component
-		for (i = 0; i < 4; i++) {
-			for (j = 0; j < len; ) {
-				unsigned char code = fgetc(file);
-				if (code > 128) { // run
-					code &= 127;
-					unsigned char val = fgetc(file);
-					while (code--)
-						scanline[j++][i] = val;
-				}
-				else {	// non-run
-					while (code--)
-						scanline[j++][i] = fgetc(file);
-				}
-			}
-		}
-
-		return feof(file) ? false : true;
-	}
-
-
-	void Image::readHdr(std::string filepath, unsigned char** pixels, int& w_, int& h_, int& d_, Type& type)
-	{
-		int i;
-		char str[200];
-		FILE* file;
-
-		file = fopen(filepath.c_str(), "rb");
-		if (!file)
-			throw std::exception("Cannot open file");
-
-		fread(str, 10, 1, file);
-		if (memcmp(str, "#?RADIANCE", 10)) {
-			fclose(file);
-			throw std::exception("Invalid file format");
-		}
-
-		fseek(file, 1, SEEK_CUR);
-
-		char cmd[200];
-		i = 0;
-		char c = 0, oldc;
-		while (true) {
-			oldc = c;
-			c = fgetc(file);
-			if (c == 0xa && oldc == 0xa)
-				break;
-			cmd[i++] = c;
-		}
-
-		char reso[200];
-		i = 0;
-		while (true) {
-			c = fgetc(file);
-			reso[i++] = c;
-			if (c == 0xa)
-				break;
-		}
-
-		int w, h;
-		if (!sscanf(reso, "-Y %ld +X %ld", &h, &w)) {
-			fclose(file);
-			throw std::exception("Invalid file format");
-		}
-
-		w_ = w;
-		h_ = h;
-		d_ = 4; // All .hdr files are 4-channel RGBE data w/ alpha component == exposure
-		float* floatPixels = new float[w * h * d_];
-
-		RGBE* scanline = new RGBE[w];
-		if (!scanline) {
-			fclose(file);
-			throw std::exception("Invalid file format");
-		}
-
-		// convert image and copy over float data.
-		type = Type::FLOAT;
-		*pixels = new unsigned char[totalBytes()];
-		unsigned int lineCount = 0;
-		for (int y = h - 1; y >= 0; y--) {
-			if (decrunchHDR(scanline, w, file) == false)
-				break;
-			workOnRGBE(scanline, w, floatPixels);
-			memcpy(*pixels + lineCount, floatPixels, w * d_ * FLOAT_SIZE);
-			floatPixels += w * d_;
-			lineCount += w * d_ * FLOAT_SIZE;
-		}
-		
-		// Cleanup.
-		delete[] scanline;
-		fclose(file);
-	}
-
-	void Image::writeHdr(std::string filepath, unsigned char* pixels, int& w, int& h, int& d, Type& type)
-	{
-		if (d != 4)
-		{
-			throw std::exception("HDR data must contain a 4th channel of exposure values");
-		}
-
-		std::ofstream ofile(filepath.c_str(), std::ios::out | std::ios::binary);
-		if (!ofile.is_open())
-			throw std::exception("Cannot open output file.");
-
-		// Write hdr header.
-		ofile << "#?RADIANCE" << char(0x0A) << "SOFTWARE=GEGL" << char(0x0A) << "FORMAT=32-bit_rle_rgbe" << char(0x0A) << char(0x0A) << "-Y " << std::to_string(h) << " +X " << std::to_string(w) << char(0x0A);
-
-		unsigned int counter = 0;
-		float px;
-		float expo2;
-		for (unsigned int i = 0; i < w * h; ++i) // assumes size of float == 4 bytes
-		{
-			memcpy(&expo2, &pixels[counter+(3 * FLOAT_SIZE)], FLOAT_SIZE);
-			int expo = int(expo2) - 128;
-			for (unsigned int j = 0; j < d; ++j)
-			{
-				if (j == 3) // Save exposure float
-				{
-					ofile << unsigned char(expo+128);
-				}
-				else // For RGB data, convert back to linear value and write to file.
-				{
-					px = 0.0f;
-					memcpy(&px, &pixels[counter], FLOAT_SIZE);
-					ofile << (unsigned char)invConvertComponent(px,expo);
-					
-				}
-				counter+=4; // assumes size of float == 4 bytess
-			}
-		}
-
-		ofile.flush();
-		ofile.close();
-	}
-
-	void Image::readJpg(std::string filepath, unsigned char** pixels, int& w, int& h, int& d, Type& type)
-	{
-		// Open file.
-		FILE* f = fopen(filepath.c_str(), "rb");
-		fseek(f, 0, SEEK_END);
-		int size = (int)ftell(f);
-		auto temparr = new unsigned char[size];
-		fseek(f, 0, SEEK_SET);
-		size = (int)fread(temparr, 1, size, f);
-		fclose(f);
-
-		// Init jpeg lib and decode bytes.
-		njInit();
-		if (njDecode(temparr, size)) {
-			delete[] temparr;
-			throw std::exception("Error decoding the input file.\n");
-		}
-
-		// Copy results to local vars.
-		d = 3;
-		w = njGetWidth();
-		h = njGetHeight();
-		*pixels = new unsigned char[totalBytes()];
-		memcpy(*pixels, njGetImage(), totalBytes());
-
-		// Cleanup.
-		delete[] temparr;
-		njDone();
-	}
-
-	void Image::writeJpg(std::string filepath, unsigned char* pixels, int& w, int& h, int& d, Type& type)
-	{
-		tje_encode_to_file(filepath.c_str(), w, h, d, pixels);
-	}
-
-	typedef struct {
-		const png_byte* data;
-		const png_size_t size;
-	} DataHandle;
-
-	typedef struct {
-		const DataHandle data;
-		png_size_t offset;
-	} ReadDataHandle;
-
-#define PNG_SIG_BYTES (8) /* bytes in the PNG file signature. */
-#define PNG_RGBA_PIXEL_LIMIT (0x1000000)
-
-	size_t Read(unsigned char* dest, unsigned char* Data, const size_t byteCount) {
-		std::copy(Data + 0, Data + byteCount, dest);
-		return byteCount;
-	}
-
-	void ReadDataFromInputStream(png_structp png_ptr, png_byte* raw_data, png_size_t read_length) {
-		ReadDataHandle* handle = (ReadDataHandle*)png_get_io_ptr(png_ptr);
-		const png_byte* png_src = handle->data.data + handle->offset;
-		memcpy(raw_data, png_src, read_length);
-		handle->offset += read_length;
-	}
-
-	static int png_rgba_pixel_limit(png_uint_32 w, png_uint_32 h) {
-		double da;
-		/* assert(w != 0 && h != 0); */
-		if (w > PNG_RGBA_PIXEL_LIMIT || h > PNG_RGBA_PIXEL_LIMIT)
-			return (1); /* since both (w) and (h) are non-zero. */
-		/* since an IEEE-754 double has a 53 bit mantissa, it can
-		* represent the maximum area: (w * h == 2^48) exactly. */
-		da = ((double)w) * ((double)h);
-		if (da > ((double)PNG_RGBA_PIXEL_LIMIT))
-			return (1);
-		return (0); /* the PNG image is within the pixel limit. */
-	}
-
-	unsigned int accessArray3D(unsigned int r, unsigned int c, unsigned int d, unsigned int rows, unsigned int cols, unsigned int depth) {
-		unsigned int idx = ((r * cols + c) * depth) + d;
-		if (idx >= cols * rows * depth) {
-			throw std::exception("ERROR! Indexing outside of array");
-		}
-		return idx;
-	}
-
-	//unsigned char* LoadPng(unsigned char* Data, int& width, int& height, int& depth, bool flip)	
-	void Image::readPng(std::string filepath, unsigned char** pixels, int& w, int& h, int& d, Type& type)
-	{
-		unsigned int sz = std::filesystem::file_size(filepath);
-		unsigned char* Data = new unsigned char[sz];
-		std::ifstream ifile(filepath, std::ios::in | std::ios::binary);
-		ifile.read(reinterpret_cast<char*>(Data), sz);		
-		ifile.close();
-
-		png_byte magic[PNG_SIG_BYTES]; /* (signature byte buffer) */
-		png_structp png_ctx;
-		png_infop info_ctx;
-		png_uint_32 img_width, img_height, row;
-		png_byte img_depth, img_color_type;
-
-		/* 'volatile' qualifier forces reload in setjmp cleanup: */
-		unsigned char* volatile img_data = NULL;
-		png_bytep* volatile row_data = NULL;
-
-		;//*buf = NULL;
-
-		 /* it is assumed that 'longjmp' can be invoked within this
-		 * code to efficiently unwind resources for *all* errors. */
-		 /* PNG structures and resource unwinding: */
-		if ((png_ctx = png_create_read_struct(
-			PNG_LIBPNG_VER_STRING, NULL, NULL, NULL)) == NULL)
-			return; /* ENOMEM (?) */
-		if ((info_ctx = png_create_info_struct(png_ctx)) == NULL)
-		{
-			png_destroy_read_struct(&png_ctx, NULL, NULL);
-			return; /* ENOMEM (?) */
-		}
-		if (setjmp(png_jmpbuf(png_ctx)) != 0)
-		{
-			png_destroy_read_struct(&png_ctx, &info_ctx, NULL);
-			free(img_data); free(row_data);
-			return; /* libpng feedback (?) */
-		}
-
-		/* check PNG file signature: */
-		Read(magic, Data, PNG_SIG_BYTES);
-
-		if (png_sig_cmp(magic, 0, PNG_SIG_BYTES))
-			png_error(png_ctx, "invalid PNG file");
-
-		/* set the input file stream and get the PNG image info: */
-		ReadDataHandle a = ReadDataHandle{ { Data, 898 }, 0 };
-		png_set_read_fn(png_ctx, &a, ReadDataFromInputStream);
-
-		//////////////// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-
-		png_read_info(png_ctx, info_ctx);
-		img_width = png_get_image_width(png_ctx, info_ctx);
-		img_height = png_get_image_height(png_ctx, info_ctx);
-
-		if (img_width == 0 || img_height == 0)
-			png_error(png_ctx, "zero area PNG image");
-		if (png_rgba_pixel_limit(img_width, img_height))
-			png_error(png_ctx, "PNG image exceeds pixel limits");
-
-		img_depth = png_get_bit_depth(png_ctx, info_ctx);
-		img_color_type = png_get_color_type(png_ctx, info_ctx);
-
-		/* ignored image interlacing, compression and filtering. */
-		/* force 8-bit color channels: */
-		if (img_depth == 16)
-			png_set_strip_16(png_ctx);
-		else if (img_depth < 8)
-			png_set_packing(png_ctx);
-		/* force formats to RGB: */
-		if (img_color_type != PNG_COLOR_TYPE_RGBA)
-			png_set_expand(png_ctx);
-		if (img_color_type == PNG_COLOR_TYPE_PALETTE)
-			png_set_palette_to_rgb(png_ctx);
-		if (img_color_type == PNG_COLOR_TYPE_GRAY)
-			png_set_gray_to_rgb(png_ctx);
-		if (img_color_type == PNG_COLOR_TYPE_GRAY_ALPHA)
-			png_set_gray_to_rgb(png_ctx);
-		/* add full opacity alpha channel if required: */
-		if (img_color_type != PNG_COLOR_TYPE_RGBA)
-			png_set_filler(png_ctx, 0xff, PNG_FILLER_AFTER);
-
-		/* apply the output transforms before reading image data: */
-		png_read_update_info(png_ctx, info_ctx);
-
-		/* allocate RGBA image data: */
-		img_data = (png_byte*)
-			malloc((size_t)(img_width * img_height * (4)));
-
-		if (img_data == NULL)
-			png_error(png_ctx, "error allocating image buffer");
-
-		/* allocate row pointers: */
-		row_data = (png_bytep*)
-			malloc((size_t)(img_height * sizeof(png_bytep)));
-		if (row_data == NULL)
-			png_error(png_ctx, "error allocating row pointers");
-
-		/* set the row pointers and read the RGBA image data: */
-		for (row = 0; row < img_height; row++)
-			row_data[row] = img_data +
-			(img_height - (row + 1)) * (img_width * (4));
-		png_read_image(png_ctx, row_data);
-
-		/* libpng and dynamic resource unwinding: */
-		png_read_end(png_ctx, NULL);
-		png_destroy_read_struct(&png_ctx, &info_ctx, NULL);
-		free(row_data);
-
-		w = img_width;
-		h = img_height;
-		d = 4; // Forced channel number to RGBA == 4.
-
-		delete[] Data;
-		*pixels = new unsigned char[totalBytes()];
-		memcpy(*pixels, img_data, totalBytes());
-
-		flip(*pixels, w, h, d, type);
-	}
-
-	void Image::writePng(std::string filepath, unsigned char* pixels, int& w, int& h, int& d, Type& type)
-	{
-		png_encoder::saveToFile(filepath,pixels,w,h,d);
-	}
-
-	int getBit(int whichBit)
-	{
-		if (whichBit > 0 && whichBit <= 8)
-			return (1 << (whichBit - 1));
-		else
-			return 0;
-	}
-    void Image::readPbm(std::string filepath, unsigned char** pixels, int& w, int& h, int& d, Type& type)
-    {
-		std::vector<std::uint8_t> data;
-		std::ifstream ifile(filepath, std::ios::in|std::ios::binary);
-		PNM::Info info;
-
-		ifile >> PNM::load(data,info);
-		w = info.width();
-		h = info.height();
-		d = info.channel();
-		bool isPfm = filepath.find(".pfm") != std::string::npos;
-		if (isPfm) // .pfm files contain float data
-		{
-			type = Type::FLOAT;
-		}
-		*pixels = new unsigned char[totalBytes()];
-		if (filepath.find(".pbm") != std::string::npos) // .pbm P4 files are binary black/white, so extract 8 bits of pixel data per byte
-		{
-			if (info.type() == PNM::P4 || info.type() == PNM::P1) // binary pixel data in 1's and 0's
-			{
-				int lastRowBits = w % 8;
-				unsigned int counter = 0;
-				bool endOfRow = false;
-				bool rowJustEnded = false;
-				for (unsigned int i = 0; i < data.size(); ++i)
-				{
-					for (unsigned int j = 0; j < 8; j++)
-					{
-						if (!rowJustEnded && counter > 0 && counter % w == 0) // skip padding bits in byte at end of row.
-						{
-							endOfRow = true;
-						}
-						else
-						{
-							rowJustEnded = false;
-						}
-
-						if (endOfRow && j >= lastRowBits)
-						{
-							endOfRow = false;
-							rowJustEnded = true;
-							break;
-						}
-
-						unsigned char px = (data[i] >> (7 - j)) & 0x01;
-						(*pixels)[counter] = px > 0 ? 0 : 255;
-						counter++;
-					}
-
-					endOfRow = false;
-				}
-			}
-			else
-			{
-				throw std::exception("Error parsing type from .pbm file");
-			}
-		}
-		else
-		{
-			memcpy(*pixels, data.data(), totalBytes());
-		}
-
-		if (isPfm)
-		{
-			flip(*pixels, w, h, d, type);
-		}
-    }
-
-    void Image::writePbm(std::string filepath, unsigned char* pixels, int& w, int& h, int& d, Type& type)
-    {
-        std::ofstream outfile(filepath, std::ofstream::binary);
-        if (outfile.fail())
-        {
-            throw std::exception("Failed to write ");
-        }
-
-		if (filepath.find(".pbm") != std::string::npos)
-		{
-			outfile << "P4" << "\n" << w << " " << h << "\n";
-
-			int lastRowBits = w % 8;
-			unsigned int counter = 0;
-			bool endOfRow = false;
-			bool rowJustEnded = false;
-			while (counter < totalBytes())
-			{
-				unsigned char byteToWrite = 0;
-				for (unsigned int j = 0; j < 8; j++)
-				{
-					if (!rowJustEnded && counter > 0 && counter % w == 0) // skip padding bits in byte at end of row.
-					{
-						endOfRow = true;
-					}
-					else
-					{
-						rowJustEnded = false;
-					}
-
-					if (endOfRow && j >= lastRowBits)
-					{
-						endOfRow = false;
-						rowJustEnded = true;
-						break;
-					}
-					
-					unsigned char px = (pixels[counter] > 0 ? 0x00 : 0x01);
-					byteToWrite |= (px << (7-j));
-					counter++;
-				}				
-				outfile << byteToWrite;
-				endOfRow = false;
-			}
-		}
-		else if (filepath.find(".pfm") != std::string::npos)
-		{
-			if (type != Type::FLOAT)
-			{
-				throw std::exception("Cannot write non-float data to .pfm");
-			}
-
-			outfile << (d == 3 ? "PF" : "Pf") << (char)0x0A << w << " " << h << (char)0x0A << "-1.0" << (char)0x0A;
-			outfile.write(reinterpret_cast<char*>(pixels), totalBytes()); // write binary
-		}
-		else if (filepath.find(".pgm") != std::string::npos || filepath.find(".ppm") != std::string::npos || filepath.find(".pnm") != std::string::npos)
-		{
-			bool isPgm = filepath.find(".pgm") != std::string::npos;
-			outfile << (isPgm ? "P5" : "P6") << "\n" << w << " " << h << "\n" << 255 << "\n";
-			outfile.write(reinterpret_cast<char*>(pixels), totalBytes()); // write binary
-		}
-		else
-		{
-			throw std::exception("Could not recognize netpbm format");
-		}
-    }
-
-	template <typename Type>
-	void RGBPaletted(Type* InBuffer, uint8_t* ColorMap, uint8_t* OutBuffer, size_t Size) {
-		const int PixelSize = 3;
-		Type Index;
-		uint8_t Red, Green, Blue;
-		uint8_t* ColorMapPtr;
-		for (size_t i = 0; i < Size; i++) {
-			Index = InBuffer[i];
-			ColorMapPtr = &ColorMap[Index * PixelSize];
-			Blue = *ColorMapPtr++;
-			Green = *ColorMapPtr++;
-			Red = *ColorMapPtr++;
-			*OutBuffer++ = Red;
-			*OutBuffer++ = Green;
-			*OutBuffer++ = Blue;
-		}
-	}
-
-	template <typename Type>
-	void RGBAPaletted(Type* InBuffer, uint8_t* ColorMap, uint8_t* OutBuffer, size_t Size) {
-		const int PixelSize = 4;
-		Type Index;
-		uint8_t Red, Green, Blue, Alpha;
-		uint8_t* ColorMapPtr;
-		for (size_t i = 0; i < Size; i++) {
-			Index = InBuffer[i];
-			ColorMapPtr = &ColorMap[Index * PixelSize];
-			Blue = *ColorMapPtr++;
-			Green = *ColorMapPtr++;
-			Red = *ColorMapPtr++;
-			Alpha = *ColorMapPtr++;
-			*OutBuffer++ = Red;
-			*OutBuffer++ = Green;
-			*OutBuffer++ = Blue;
-			*OutBuffer++ = Alpha;
-		}
-	}
-
-	void MonochromeCompressed(uint8_t* InBuffer, uint8_t* OutBuffer, size_t Size) {
-		uint8_t Header;
-		uint8_t Red;
-		size_t i, j, PixelCount;
-		for (i = 0; i < Size; ) {
-			Header = *InBuffer++;
-			PixelCount = (Header & 0x7F) + 1;
-			if (Header & 0x80) {
-				Red = *InBuffer++;
-				for (j = 0; j < PixelCount; j++)
-					*OutBuffer++ = Red;
-				i += PixelCount;
-			}
-			else {
-				for (j = 0; j < PixelCount; j++) {
-					Red = *InBuffer++;
-					*OutBuffer++ = Red;
-				}
-				i += PixelCount;
-			}
-		}
-	}
-
-	void RGBCompressed(uint8_t* InBuffer, uint8_t* OutBuffer, size_t Size) {
-		uint8_t Header;
-		uint8_t Red, Green, Blue;
-		size_t i, j, PixelCount;
-		for (i = 0; i < Size; ) {
-			Header = *InBuffer++;
-			PixelCount = (Header & 0x7F) + 1;
-
-			if (Header & 0x80) {
-				Blue = *InBuffer++;
-				Green = *InBuffer++;
-				Red = *InBuffer++;
-				for (j = 0; j < PixelCount; j++) {
-					*OutBuffer++ = Red;
-					*OutBuffer++ = Green;
-					*OutBuffer++ = Blue;
-				}
-				i += PixelCount;
-			}
-			else {
-				for (j = 0; j < PixelCount; j++) {
-					Blue = *InBuffer++;
-					Green = *InBuffer++;
-					Red = *InBuffer++;
-					*OutBuffer++ = Red;
-					*OutBuffer++ = Green;
-					*OutBuffer++ = Blue;
-				}
-				i += PixelCount;
-			}
-		}
-	}
-
-	void RGBACompressed(uint8_t* InBuffer, uint8_t* OutBuffer, size_t Size) {
-		uint8_t Header;
-		uint8_t Red, Green, Blue, Alpha;
-		size_t i, j, PixelCount;
-
-		for (i = 0; i < Size; ) {
-			Header = *InBuffer++;
-			PixelCount = (Header & 0x7F) + 1;
-
-			if (Header & 0x80) {
-				Blue = *InBuffer++;
-				Green = *InBuffer++;
-				Red = *InBuffer++;
-				Alpha = *InBuffer++;
-
-				for (j = 0; j < PixelCount; j++) {
-					*OutBuffer++ = Red;
-					*OutBuffer++ = Green;
-					*OutBuffer++ = Blue;
-					*OutBuffer++ = Alpha;
-				}
-				i += PixelCount;
-			}
-			else {
-				for (j = 0; j < PixelCount; j++) {
-					Blue = *InBuffer++;
-					Green = *InBuffer++;
-					Red = *InBuffer++;
-					Alpha = *InBuffer++;
-
-					*OutBuffer++ = Red;
-					*OutBuffer++ = Green;
-					*OutBuffer++ = Blue;
-					*OutBuffer++ = Alpha;
-				}
-				i += PixelCount;
-			}
-		}
-	}
-
-	// Modified from: https://github.com/ColumbusUtrigas/TGA
-	void Image::readTga(std::string filepath, unsigned char** pixels, int& w, int& h, int& d, Type& type)
-	{
-		std::ifstream File(filepath, std::ios::binary);
-		if (!File.is_open()) return;
-		struct Header {
-			uint8_t IDLength;
-			uint8_t ColorMapType;
-			uint8_t ImageType;
-			uint16_t ColorMapOrigin;
-			uint16_t ColorMapLength;
-			uint8_t  ColorMapEntrySize;
-			uint16_t XOrigin;
-			uint16_t YOrigin;
-			uint16_t Width;
-			uint16_t Height;
-			uint8_t  Bits;
-			uint8_t  ImageDescriptor;
-		} Head;
-		size_t FileSize = std::filesystem::file_size(filepath);
-		File.read((char*)&Head.IDLength, sizeof(Head.IDLength));
-		File.read((char*)&Head.ColorMapType, sizeof(Head.ColorMapType));
-		File.read((char*)&Head.ImageType, sizeof(Head.ImageType));
-		File.read((char*)&Head.ColorMapOrigin, sizeof(Head.ColorMapOrigin));
-		File.read((char*)&Head.ColorMapLength, sizeof(Head.ColorMapLength));
-		File.read((char*)&Head.ColorMapEntrySize, sizeof(Head.ColorMapEntrySize));
-		File.read((char*)&Head.XOrigin, sizeof(Head.XOrigin));
-		File.read((char*)&Head.YOrigin, sizeof(Head.YOrigin));
-		File.read((char*)&Head.Width, sizeof(Head.Width));
-		File.read((char*)&Head.Height, sizeof(Head.Height));
-		File.read((char*)&Head.Bits, sizeof(Head.Bits));
-		File.read((char*)&Head.ImageDescriptor, sizeof(Head.ImageDescriptor));
-		uint8_t* Descriptor = new uint8_t[Head.ImageDescriptor];
-		File.read((char*)Descriptor, Head.ImageDescriptor);
-		size_t ColorMapElementSize = Head.ColorMapEntrySize / 8;
-		size_t ColorMapSize = Head.ColorMapLength * ColorMapElementSize;
-		uint8_t* ColorMap = new uint8_t[ColorMapSize];
-		if (Head.ColorMapType == 1)
-			File.read((char*)ColorMap, ColorMapSize);
-		size_t PixelSize = Head.ColorMapLength == 0 ? (Head.Bits / 8) : ColorMapElementSize;
-		size_t DataSize = FileSize - sizeof(Header) - (Head.ColorMapType == 1 ? ColorMapSize : 0);
-		size_t ImageSize = Head.Width * Head.Height * PixelSize;
-		uint8_t* Buffer = new uint8_t[DataSize];
-		File.read((char*)Buffer, DataSize);
-		*pixels = new unsigned char[ImageSize];
-		memset(*pixels, 0, ImageSize);
-		switch (Head.ImageType) {
-			case 0: break; // No Image
-			case 1: {// Uncompressed paletted		
-				if (Head.Bits == 8) {
-					switch (PixelSize) {
-					case 3: RGBPaletted((uint8_t*)Buffer, ColorMap, *pixels, Head.Width * Head.Height); break;
-					case 4: RGBAPaletted((uint8_t*)Buffer, ColorMap, *pixels, Head.Width * Head.Height); break;
-					}
-				}
-				else if (Head.Bits == 16) {
-					switch (PixelSize) {
-					case 3: RGBPaletted((uint16_t*)Buffer, ColorMap, *pixels, Head.Width * Head.Height); break;
-					case 4: RGBAPaletted((uint16_t*)Buffer, ColorMap, *pixels, Head.Width * Head.Height); break;
-					}
-				}
-				break;
-			}
-			case 2: {// Uncompressed TrueColor		
-				if (Head.Bits = 24 || Head.Bits == 32) {
-					std::copy(&Buffer[0], &Buffer[ImageSize], *pixels);
-
-					// Swap R<->B channels.
-					for (size_t i = 0; i < ImageSize; i += PixelSize)
-					{
-						std::swap((*pixels)[i], (*pixels)[i + 2]);						
-					}
-				}
-				break;
-			}
-			case 3: {// Uncompressed Monochrome		
-				if (Head.Bits == 8)
-					std::copy(&Buffer[0], &Buffer[ImageSize], &(*pixels)[0]);
-				break;
-			}
-			case 9: break; // Compressed paletted TODO
-			case 10: {// Compressed TrueColor		
-				switch (Head.Bits)
-				{
-				case 24: RGBCompressed(Buffer, *pixels, Head.Width * Head.Height); break;
-				case 32: RGBACompressed(Buffer, *pixels, Head.Width * Head.Height); break;
-				}
-				break;
-			}
-			case 11: {// Compressed Monocrhome		
-				if (Head.Bits == 8)
-					MonochromeCompressed(Buffer, *pixels, Head.Width * Head.Height);
-				break;
-			}
-		}
-
-		if (Head.ImageType != 0) {
-			d = PixelSize;
-			w = Head.Width;
-			h = Head.Height;
-			flip(*pixels, w, h, d, type); // for some reason, this code loads the .tga data upside down
-		}
-		delete[] ColorMap;
-		delete[] Descriptor;
-	}
-
-	// NOTE: only writes uncompressed .tga for now.
-    void Image::writeTga(std::string filepath, unsigned char* pixels, int& w, int& h, int& d, Type& type)
-    {
-        FILE* fp = NULL;
-        fp = fopen(filepath.c_str(), "wb");
-        if (fp == NULL)
-            return;
-
-        unsigned char header[18] =
-        {
-            0,0,2,0,0,0,0,0,0,0,0,0,
-            (unsigned char)(w % 256),
-            (unsigned char)(w / 256),
-            (unsigned char)(h % 256),
-            (unsigned char)(h / 256),
-            (unsigned char)(d * 8),
-            0x20
-        };
-        fwrite(&header, 18, 1, fp);
-
-        for (int i = 0; i < w * h; i++)
-        {
-            for (int b = 0; b < d; b++)
-            {
-                fputc(pixels[(i * d) + (b % d)], fp);
-            }
-        }
-        fclose(fp);
-    }
-
-	void Image::readTiff(std::string filepath, unsigned char** pixels, int& w, int& h, int& d, Type& type)
-    {
-		TIFF* tif = TIFFOpen(filepath.c_str(), "r");
-		uint32_t* buf;
-		tsize_t scanlineSz;
-		TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &w);
-		TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &h);
-		TIFFGetField(tif, TIFFTAG_SAMPLESPERPIXEL, &d);
-		int bitDepth = 0;
-		TIFFGetField(tif, TIFFTAG_BITSPERSAMPLE, &bitDepth);
-		if (bitDepth > 8)
-		{
-			switch (bitDepth)
-			{
-			case 16:
-				type = Type::USHORT;
-			case 32:
-				type = Type::FLOAT;
-			}
-		}
-		*pixels = new unsigned char[totalBytes()];
-
-		scanlineSz = TIFFScanlineSize(tif);
-		buf = new uint32_t[w*h];//(tdata_t*)_TIFFmalloc(scanlineSz);
-		if (!TIFFReadRGBAImage(tif, (uint32_t)w, (uint32_t)h, (uint32_t*)buf, 1))
-		{
-			std::cerr << "Error reading .tiff file" << std::endl;
-			throw std::exception("Error reading .tff file");
-		}
-		unsigned int counter = 0;
-
-		for (unsigned int i = 0; i < w * h; ++i)
-		{
-			uint32_t currPix = (uint32_t)buf[i];
-			for (unsigned int j = 0; j < d; ++j)
-			{
-				unsigned char currByte = unsigned char((currPix >> j) & 0xff);
-				(*pixels)[counter] = currByte;
-				counter++;
-			}
-		}
-
-		// Cleanup.
-		delete[] buf;
-		flip();
-	}
-	void Image::writeTiff(std::string filepath, unsigned char* pixels, int& w, int& h, int& d, Type& type)
-    {
-		TIFF* tif = TIFFOpen(filepath.c_str(), "w");
-		TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, w);
-		TIFFSetField(tif, TIFFTAG_IMAGELENGTH, h);
-		TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, d);
-
-		switch (type)
-		{
-		case Type::FLOAT:
-			TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, 32);
-			break;
-		case Type::USHORT:
-			TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, 16);
-			break;
-		default:
-			TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, 8);
-			break;
-		}
-
-		TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, h);
-		TIFFSetField(tif, TIFFTAG_COMPRESSION, COMPRESSION_ADOBE_DEFLATE);
-		TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_RGB);
-		TIFFSetField(tif, TIFFTAG_FILLORDER, FILLORDER_MSB2LSB);
-		TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
-
-		TIFFWriteEncodedStrip(tif, 0,const_cast<void*>(reinterpret_cast<const void*> (pixels)),tsize_t(totalBytes()));
-		TIFFClose(tif);
-	}
-
-	void Image::readWebp(std::string filepath, unsigned char** pixels, int& w, int& h, int& d, Type& type)
-    {		
-		// Validate header.
-		std::ifstream ifile(filepath, std::ios::in | std::ios::binary);
-		if (!ifile.is_open())
-		{
-			throw std::exception(("Could not open .webp file: " + filepath).c_str());
-		}
-		std::vector<uint8_t> data;
-		while (ifile.good())
-		{
-			data.push_back((uint8_t)ifile.get());
-		}
-		auto sz = std::filesystem::file_size(filepath);
-
-		// Read contents.
-		if (!WebPGetInfo(data.data(), sz, &w, &h))
-		{
-			throw std::exception("Could not parse .webp header");
-		}
-		*pixels = WebPDecodeRGBA(data.data(), sz, &w, &h);
-		d = 4; // in this setup, webp is RGBA by default
-    }
-
-	typedef struct MetadataPayload {
-		uint8_t* bytes;
-		size_t size;
-	} MetadataPayload;
-
-	typedef struct Metadata {
-		MetadataPayload exif;
-		MetadataPayload iccp;
-		MetadataPayload xmp;
-	} Metadata;
-
-	// Metadata writing.
-
-	enum {
-		METADATA_EXIF = (1 << 0),
-		METADATA_ICC = (1 << 1),
-		METADATA_XMP = (1 << 2),
-		METADATA_ALL = METADATA_EXIF | METADATA_ICC | METADATA_XMP
-	};
-
-	static const int kChunkHeaderSize = 8;
-	static const int kTagSize = 4;
-
-	// Sets 'flag' in 'vp8x_flags' and updates 'metadata_size' with the size of the
-	// chunk if there is metadata and 'keep' is true.
-	static int UpdateFlagsAndSize(const MetadataPayload* const payload,
-		int keep, int flag,
-		uint32_t* vp8x_flags, uint64_t* metadata_size) {
-		if (keep && payload->bytes != NULL && payload->size > 0) {
-			*vp8x_flags |= flag;
-			*metadata_size += kChunkHeaderSize + payload->size + (payload->size & 1);
-			return 1;
-		}
-		return 0;
-	}
-
-	// Outputs, in little endian, 'num' bytes from 'val' to 'out'.
-	static int WriteLE(FILE* const out, uint32_t val, int num) {
-		uint8_t buf[4];
-		int i;
-		for (i = 0; i < num; ++i) {
-			buf[i] = (uint8_t)(val & 0xff);
-			val >>= 8;
-		}
-		return (fwrite(buf, num, 1, out) == 1);
-	}
-
-	static int WriteLE24(FILE* const out, uint32_t val) {
-		return WriteLE(out, val, 3);
-	}
-
-	static int WriteLE32(FILE* const out, uint32_t val) {
-		return WriteLE(out, val, 4);
-	}
-
-	static int WriteMetadataChunk(FILE* const out, const char fourcc[4],
-		const MetadataPayload* const payload) {
-		const uint8_t zero = 0;
-		const size_t need_padding = payload->size & 1;
-		int ok = (fwrite(fourcc, kTagSize, 1, out) == 1);
-		ok = ok && WriteLE32(out, (uint32_t)payload->size);
-		ok = ok && (fwrite(payload->bytes, payload->size, 1, out) == 1);
-		return ok && (fwrite(&zero, need_padding, need_padding, out) == need_padding);
-	}
-
-	static int WriteWebPWithMetadata(FILE* const out,
-		const WebPPicture* const picture,
-		const WebPMemoryWriter* const memory_writer,
-		const Metadata* const metadata,
-		int keep_metadata,
-		int* const metadata_written) {
-		const char kVP8XHeader[] = "VP8X\x0a\x00\x00\x00";
-		const int kAlphaFlag = 0x10;
-		const int kEXIFFlag = 0x08;
-		const int kICCPFlag = 0x20;
-		const int kXMPFlag = 0x04;
-		const size_t kRiffHeaderSize = 12;
-		const size_t kMaxChunkPayload = ~0 - kChunkHeaderSize - 1;
-		const size_t kMinSize = kRiffHeaderSize + kChunkHeaderSize;
-		uint32_t flags = 0;
-		uint64_t metadata_size = 0;
-		const int write_exif = UpdateFlagsAndSize(&metadata->exif,
-			!!(keep_metadata & METADATA_EXIF),
-			kEXIFFlag, &flags, &metadata_size);
-		const int write_iccp = UpdateFlagsAndSize(&metadata->iccp,
-			!!(keep_metadata & METADATA_ICC),
-			kICCPFlag, &flags, &metadata_size);
-		const int write_xmp = UpdateFlagsAndSize(&metadata->xmp,
-			!!(keep_metadata & METADATA_XMP),
-			kXMPFlag, &flags, &metadata_size);
-		uint8_t* webp = memory_writer->mem;
-		size_t webp_size = memory_writer->size;
-
-		*metadata_written = 0;
-
-		if (webp_size < kMinSize) return 0;
-		if (webp_size - kChunkHeaderSize + metadata_size > kMaxChunkPayload) {
-			fprintf(stderr, "Error! Addition of metadata would exceed "
-				"container size limit.\n");
-			return 0;
-		}
-
-		if (metadata_size > 0) {
-			const int kVP8XChunkSize = 18;
-			const int has_vp8x = !memcmp(webp + kRiffHeaderSize, "VP8X", kTagSize);
-			const uint32_t riff_size = (uint32_t)(webp_size - kChunkHeaderSize +
-				(has_vp8x ? 0 : kVP8XChunkSize) +
-				metadata_size);
-			// RIFF
-			int ok = (fwrite(webp, kTagSize, 1, out) == 1);
-			// RIFF size (file header size is not recorded)
-			ok = ok && WriteLE32(out, riff_size);
-			webp += kChunkHeaderSize;
-			webp_size -= kChunkHeaderSize;
-			// WEBP
-			ok = ok && (fwrite(webp, kTagSize, 1, out) == 1);
-			webp += kTagSize;
-			webp_size -= kTagSize;
-			if (has_vp8x) {  // update the existing VP8X flags
-				webp[kChunkHeaderSize] |= (uint8_t)(flags & 0xff);
-				ok = ok && (fwrite(webp, kVP8XChunkSize, 1, out) == 1);
-				webp += kVP8XChunkSize;
-				webp_size -= kVP8XChunkSize;
-			}
-			else {
-				const int is_lossless = !memcmp(webp, "VP8L", kTagSize);
-				if (is_lossless) {
-					// Presence of alpha is stored in the 37th bit (29th after the
-					// signature) of VP8L data.
-					if (webp[kChunkHeaderSize + 4] & (1 << 4)) flags |= kAlphaFlag;
-				}
-				ok = ok && (fwrite(kVP8XHeader, kChunkHeaderSize, 1, out) == 1);
-				ok = ok && WriteLE32(out, flags);
-				ok = ok && WriteLE24(out, picture->width - 1);
-				ok = ok && WriteLE24(out, picture->height - 1);
-			}
-			if (write_iccp) {
-				ok = ok && WriteMetadataChunk(out, "ICCP", &metadata->iccp);
-				*metadata_written |= METADATA_ICC;
-			}
-			// Image
-			ok = ok && (fwrite(webp, webp_size, 1, out) == 1);
-			if (write_exif) {
-				ok = ok && WriteMetadataChunk(out, "EXIF", &metadata->exif);
-				*metadata_written |= METADATA_EXIF;
-			}
-			if (write_xmp) {
-				ok = ok && WriteMetadataChunk(out, "XMP ", &metadata->xmp);
-				*metadata_written |= METADATA_XMP;
-			}
-			return ok;
-		}
-
-		// No metadata, just write the original image file.
-		return (fwrite(webp, webp_size, 1, out) == 1);
-	}
-
-
-	void Image::writeWebp(std::string filepath, unsigned char* pixels, int& w, int& h, int& d, Type& type)
-    {	
-		WebPPicture pic;
-		WebPPictureInit(&pic);
-		pic.width = w;
-		pic.height = h;		
-		pic.argb_stride = w * d * byteSize();
-		WebPPictureImportRGBA(&pic,pixels,w*d*byteSize());
-		if (pic.error_code)
-		{
-			throw std::exception(("WebPEncode failed. Error code: " + std::to_string((int)pic.error_code)).c_str());
-		}
-
-		// Extract a configuration from the packed bits.
-		WebPConfig config;
-		WebPConfigInit(&config);
-		WebPConfigLosslessPreset(&config, 6);
-		if (!WebPValidateConfig(&config)) {
-			throw std::exception("Error! Invalid configuration.");
-		}
-
-
-		// Encode.
-		WebPMemoryWriter memory_writer;
-		WebPMemoryWriterInit(&memory_writer);		
-		pic.writer = WebPMemoryWrite;
-		pic.custom_ptr = &memory_writer;		
-		if (!WebPEncode(&config, &pic)) {
-			const WebPEncodingError error_code = pic.error_code;
-			WebPMemoryWriterClear(&memory_writer);
-			WebPPictureFree(&pic);
-			if (error_code == VP8_ENC_ERROR_OUT_OF_MEMORY ||
-				error_code == VP8_ENC_ERROR_BAD_WRITE) {
-				return;
-			}
-			throw std::exception(("WebPEncode failed. Error code: " + std::to_string((int)error_code)).c_str());
-		}
-
-		FILE* out = fopen(filepath.c_str(), "wb");
-		Metadata metadata;
-		int metadata_written;
-
-		if (!WriteWebPWithMetadata(out, &pic, &memory_writer, &metadata,
-				false, &metadata_written)) {
-			throw std::exception("Error writing WebP file!\n");		
-		}
-
-		WebPMemoryWriterClear(&memory_writer);
-		WebPPictureFree(&pic);
-		fclose(out);
-    }
+#include "codecs.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <filesystem>
+#include <iostream>
+#include <new>
+
+#include "gif.h"
+#include "mapped_file.h"
+
+#define TJE_IMPLEMENTATION
+#include "jpeg_enc.h"
+#include "jpeg_dec.h"
+
+#define NV_DDS_NO_GL_SUPPORT
+#include "nv_dds.h"
+#include "bcn.h"
+#include "mipmap.h"
+
+#ifndef IMAGECODECS_NO_LIBPNG
+#include "png.h"
+#endif
+#include "png_encoder.h"
+
+#include "pnm.h"
+#include "thread_pool.h"
+
+extern "C" {
+	#include <tiffio.h>
+}
+
+#define TINYEXR_IMPLEMENTATION
+#define TINYEXR_USE_MINIZ 1
+// EXR chunks are decompressed and compressed on the shared pool, not on threads tinyexr starts per call
+#define TINYEXR_USE_THREAD 1
+#define TINYEXR_NUM_THREADS() ImageCodecs::ThreadPool::global().size()
+#define TINYEXR_RUN_WORKERS(numThreads, worker) \
+	ImageCodecs::ThreadPool::global().parallelFor(0, (size_t)(numThreads), [&](size_t) { worker(); })
+#include "tinyexr.h"
+
+// required libs
+#pragma comment(lib, "jpeg.lib")
+#pragma comment(lib, "lzma.lib")
+#pragma comment(lib, "miniz.lib")
+#pragma comment(lib, "libwebp.lib")
+#ifdef NDEBUG
+#pragma comment(lib, "zlib.lib")
+#ifndef IMAGECODECS_NO_LIBPNG
+#pragma comment(lib, "libpng16.lib")
+#endif
+#pragma comment(lib, "tiff.lib")
+#else
+#pragma comment(lib, "zlibd.lib")
+#ifndef IMAGECODECS_NO_LIBPNG
+#pragma comment(lib, "libpng16d.lib")
+#endif
+#pragma comment(lib, "tiffd.lib")
+#endif
+
+#ifndef IMAGECODECS_NO_LIBPNG
+#include <libpng16/png.h>
+#endif
+
+#include <webp/encode.h>
+#include <webp/decode.h>
+
+namespace ImageCodecs
+{
+	void setThreadCount(unsigned numThreads)
+	{
+		ThreadPool::global().resize(numThreads == 0 ? std::thread::hardware_concurrency() : numThreads);
+	}
+
+	unsigned threadCount()
+	{
+		return ThreadPool::global().size();
+	}
+
+	void Image::read(std::string filepath, const ReadOptions& options)
+	{
+		layers_ = 1;
+		layout_ = Layout::FLAT;
+		bottomUp_ = false;
+		auto ext = std::filesystem::path(filepath).extension().string();
+		for (auto& c : ext)
+			c = std::tolower(c);
+		if (ext == ".bmp")
+			readBmp(filepath, &pixels_, w_, h_, d_,type_);
+		else if (ext == ".dds")
+			readDds(filepath, &pixels_, w_, h_, d_, type_, options);
+		else if (ext == ".exr")
+			readExr(filepath, &pixels_, w_, h_, d_, type_);
+		else if (ext == ".gif")
+			readGif(filepath, &pixels_, w_, h_, d_, type_);
+		else if (ext == ".hdr")
+			readHdr(filepath, &pixels_, w_, h_, d_, type_);
+		else if (ext == ".jpg" || ext == ".jpeg")
+			readJpg(filepath, &pixels_, w_, h_, d_, type_);
+		else if (ext == ".png")
+			readPng(filepath, &pixels_, w_, h_, d_, type_, options);
+		else if (ext == ".pbm" || ext == ".pfm" || ext == ".pgm" || ext == ".pnm" || ext == ".ppm")
+			readPbm(filepath, &pixels_, w_, h_, d_, type_);
+		else if (ext == ".tga")
+			readTga(filepath, &pixels_, w_, h_, d_, type_);
+		else if (ext == ".tif" || ext == ".tiff")
+			readTiff(filepath, &pixels_, w_, h_, d_, type_);
+		else if (ext == ".webp")
+			readWebp(filepath, &pixels_, w_, h_, d_, type_);
+		else
+		{
+			throw std::invalid_argument("Cannot parse filetype");
+		}
+
+		if (pixels_ == nullptr)
+		{
+			throw std::exception("Could not read image data");
+		}
+	}
+
+	void Image::write(std::string filepath, const WriteOptions& options)
+	{
+		auto ext = std::filesystem::path(filepath).extension().string();
+		for (auto& c : ext)
+			c = std::tolower(c);
+		// BMP, PFM and TGA files take rows in either order, and DDS flips compressed blocks instead of pixels where it
+		// can. The other formats need rows top to bottom, which the image keeps once they are flipped here.
+		if (bottomUp_ && ext != ".bmp" && ext != ".dds" && ext != ".pfm" && ext != ".tga")
+			setBottomUp(false);
+		if (ext == ".bmp")
+			writeBmp(filepath, pixels_, w_, h_, d_, type_);
+		else if (ext == ".dds")
+			writeDds(filepath, pixels_, w_, h_, d_, type_, options);
+		else if (ext == ".exr")
+			writeExr(filepath, pixels_, w_, h_, d_, type_);
+		else if (ext == ".gif")
+			writeGif(filepath, pixels_, w_, h_, d_, type_, options);
+		else if (ext == ".hdr")
+			writeHdr(filepath, pixels_, w_, h_, d_, type_);
+		else if (ext == ".jpg" || ext == ".jpeg")
+			writeJpg(filepath, pixels_, w_, h_, d_, type_);
+		else if (ext == ".png")
+			writePng(filepath, pixels_, w_, h_, d_, type_, options);
+		else if (ext == ".pbm" || ext == ".pfm" || ext == ".pgm" || ext == ".pnm" || ext == ".ppm")
+			writePbm(filepath, pixels_, w_, h_, d_, type_);
+		else if (ext == ".tga")
+			writeTga(filepath, pixels_, w_, h_, d_, type_);
+		else if (ext == ".tiff" || ext == ".tif")
+			writeTiff(filepath, pixels_, w_, h_, d_, type_);
+		else if (ext == ".webp")
+			writeWebp(filepath, pixels_, w_, h_, d_, type_);
+		else
+		{
+			throw std::invalid_argument("Cannot parse filetype");
+		}
+	}
+
+	void Image::transpose(unsigned char* pixels, const int w, const int h, const int d, const Type& type)
+	{
+		unsigned int byteSz = byteSize(type);
+		unsigned char* tempPix = new unsigned char[layerBytes()];
+
+		// Copy pixels in reverse order.
+		for (unsigned int i = 0; i < h; ++i)
+		{
+			for (unsigned int j = 0; j < w; ++j)
+			{
+				for (unsigned int k = 0; k < d * byteSz; k += byteSz)
+				{
+					unsigned int r = i * w * d * byteSz;
+					unsigned int c = j * d * byteSz;
+					unsigned int r2 = j * h * d * byteSz;
+					unsigned int c2 = i * d * byteSz;
+
+					if (type == Type::FLOAT)
+					{
+						memcpy(&tempPix[r + c + k], &pixels[r2 + c2 + k], FLOAT_SIZE);
+					}
+					else
+					{
+						tempPix[r + c + k] = pixels[r2 + c2 + k];
+					}
+				}
+			}
+		}
+
+		// Now copy back over to original array.
+		for (size_t i = 0; i < layerBytes(); ++i)
+		{
+			pixels[i] = tempPix[i];
+		}
+		delete[] tempPix;
+	}
+
+
+	void Image::flip(unsigned char* pixels, const int w, const int h, const int d, const Type& type)
+	{
+		const size_t rowBytes = (size_t)w * d * byteSize(type);
+		unsigned char* tempRow = new unsigned char[rowBytes];
+
+		// Swap rows from both ends in place.
+		for (int i = 0; i < h / 2; ++i)
+		{
+			unsigned char* top = pixels + i * rowBytes;
+			unsigned char* bottom = pixels + (h - 1 - i) * rowBytes;
+			memcpy(tempRow, top, rowBytes);
+			memcpy(top, bottom, rowBytes);
+			memcpy(bottom, tempRow, rowBytes);
+		}
+		delete[] tempRow;
+	}
+
+	void Image::swapBR(unsigned char* pixels, const int w, const int h, const int d, const Type& type)
+	{
+		unsigned int byteSz = byteSize(type);
+		unsigned char* tempPix = new unsigned char[layerBytes()];
+
+		// Copy pixels in reverse order.
+		for (unsigned int i = 0; i < h; ++i)
+		{
+			for (unsigned int j = 0; j < w; ++j)
+			{
+				for (unsigned int k = 0; k < d * byteSz; k += byteSz)
+				{
+					unsigned int r = i * w * d * byteSz;
+					unsigned int c = j * d * byteSz;
+
+					if (type == Type::FLOAT)
+					{
+						if (k == 0)
+						{
+							memcpy(&tempPix[r + c + 0], &pixels[r + c + 2], FLOAT_SIZE);
+						}
+						else if (k == 2)
+						{
+							memcpy(&tempPix[r + c + 2], &pixels[r + c + 0], FLOAT_SIZE);
+						}
+						else {
+							memcpy(&tempPix[r + c + k], &pixels[r + c + k], FLOAT_SIZE);
+						}
+					}
+					else
+					{
+						if (k == 0)
+						{
+							tempPix[r + c + 0] = pixels[r + c + 2];
+						}
+						else if (k == 2)
+						{
+							tempPix[r + c + 2] = pixels[r + c + 0];
+						}
+						else {
+							tempPix[r + c + k] = pixels[r + c + k];
+						}
+					}
+				}
+			}
+		}
+
+		// Now copy back over to original array.
+		for (size_t i = 0; i < layerBytes(); ++i)
+		{
+			pixels[i] = tempPix[i];
+		}
+		delete[] tempPix;
+	}
+
+	// Adapted from: https://github.com/marc-q/libbmp/blob/master/CPP/libbmp.cpp
+	// NOTE: handles only 3 channel RGB .bmp files with 'BITMAPINFOHEADER' format
+	void Image::readBmp(std::string filepath, unsigned char** pixels, int& w, int& h, int& d, Type& type)
+	{
+		const uint32_t BMP_MAGIC = 19778;
+		struct {
+			unsigned int bfSize = 0;
+			unsigned int bfReserved = 0;
+			unsigned int bfOffBits = 54;
+			unsigned int biSize = 40;
+			int biWidth = 0;
+			int biHeight = 0;
+			unsigned short biPlanes = 1;
+			unsigned short biBitCount = 24;
+			unsigned int biCompression = 0;
+			unsigned int biSizeImage = 0;
+			int biXPelsPerMeter = 0;
+			int biYPelsPerMeter = 0;
+			unsigned int biClrUsed = 0;
+			unsigned int biClrImportant = 0;
+		} header;
+
+		struct {
+			size_t len_row;
+			size_t len_pixel = 3;
+		} bmpPixBuf;
+
+		std::ifstream f_img(filepath.c_str(), std::ios::binary);
+		if (!f_img.is_open())
+			throw std::exception("Could not open .bmp file");
+
+		// Check if its an bmp file by comparing the magic nbr
+		unsigned short magic;
+		f_img.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+
+		if (magic != BMP_MAGIC)
+		{
+			f_img.close();
+			throw std::exception("Could not parse .bmp file");
+		}
+
+		// Read the header structure into header
+		f_img.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+		// Rows are kept in the order of the file: bottom-up, unless the height is negative
+		h = std::abs(header.biHeight);
+		w = header.biWidth;
+		d = 3;
+		bottomUp_ = header.biHeight > 0;
+		const int padding = (header.biWidth % 4);
+
+		// Allocate the pixel buffer		
+		bmpPixBuf.len_row = header.biWidth * bmpPixBuf.len_pixel;
+		*pixels = new unsigned char[h * bmpPixBuf.len_row];		
+
+		if (padding == 0)
+		{
+			// Rows without padding follow each other as they do in memory
+			f_img.read(reinterpret_cast<char*>(*pixels), h * bmpPixBuf.len_row);
+		}
+		else
+		{
+			for (int y = 0; y < h; y++)
+			{
+				// Read a whole row of pixels from the file
+				f_img.read(reinterpret_cast<char*> (&(*pixels)[y * bmpPixBuf.len_row]), bmpPixBuf.len_row);
+
+				// Skip the padding
+				f_img.seekg(padding, std::ios::cur);
+			}
+		}
+
+		f_img.close();
+	}
+
+	// Adapted from: https://github.com/marc-q/libbmp/blob/master/CPP/libbmp.cpp
+	// NOTE: handles only 3 channel RGB .bmp files with 'BITMAPINFOHEADER' format
+	void Image::writeBmp(std::string filepath, unsigned char* pixels, int& w, int& h, int& d, Type& type)
+	{
+		const uint32_t BMP_MAGIC = 19778;
+		struct {
+			unsigned int bfSize = 0;
+			unsigned int bfReserved = 0;
+			unsigned int bfOffBits = 54;
+			unsigned int biSize = 40;
+			int biWidth = 0;
+			int biHeight = 0;
+			unsigned short biPlanes = 1;
+			unsigned short biBitCount = 24;
+			unsigned int biCompression = 0;
+			unsigned int biSizeImage = 0;
+			int biXPelsPerMeter = 0;
+			int biYPelsPerMeter = 0;
+			unsigned int biClrUsed = 0;
+			unsigned int biClrImportant = 0;
+		} header;
+
+		header.bfSize = (3 * w + (w % 4)) * h;
+		header.biWidth = w;
+		header.biHeight = h;
+
+		// Open the image file in binary mode
+		std::ofstream f_img(filepath.c_str(), std::ios::binary);
+
+		if (!f_img.is_open())
+			throw std::exception("Could not open .bmp file to write");
+
+		// Since an adress must be passed to fwrite, create a variable!
+		const unsigned short magic = BMP_MAGIC;
+
+		f_img.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+		f_img.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		// Rows are written bottom-up, whichever way the image keeps them
+		const int padding = header.biWidth % 4;
+
+		for (int y = h - 1; y >= 0; y--)
+		{
+			// Write a whole row of pixels into the file
+			uint32_t len_row = w * d;
+			f_img.write(reinterpret_cast<char*> (row(y)), len_row);
+
+			// Write the padding
+			f_img.write("\0\0\0", padding);
+		}
+
+		f_img.close();
+	}
+
+	void Image::readDds(std::string filepath, unsigned char** pixels, int& w, int& h, int& d, Type& type, const ReadOptions& options)
+	{
+		nv_dds::CDDSImage image;
+		unsigned char* data = nullptr;
+		size_t dataBytes = 0;
+		try
+		{
+			// DDS rows are stored top to bottom like ours, so the image is not flipped for OpenGL. Only the
+			// requested mipmap level is read. Uncompressed faces, slices and layers are read straight into our
+			// pixels, one after the other.
+			image.load(filepath, false, std::max(0, options.ddsMipLevel), [&](size_t size) -> uint8_t* {
+				if (image.is_compressed())
+					return nullptr;
+				data = new unsigned char[size];
+				dataBytes = size;
+				return data;
+			});
+		}
+		catch (std::exception e1)
+		{
+			delete[] data;
+			throw std::exception(e1.what());
+		}
+
+		w = image.get_width();
+		h = image.get_height();
+		d = image.get_components();
+
+		switch (image.get_type()) {
+		case nv_dds::TextureType::TextureFlat:
+			layers_ = image.get_num_surfaces();
+			layout_ = layers_ > 1 ? Layout::ARRAY : Layout::FLAT;
+			break;
+		case nv_dds::TextureType::TextureCubemap:
+			layers_ = image.get_num_surfaces();
+			layout_ = Layout::CUBEMAP;
+			break;
+		case nv_dds::TextureType::Texture3D:
+			layers_ = image.get_depth();
+			layout_ = Layout::VOLUME;
+			break;
+		}
+
+		// Block compressed surfaces are expanded straight into their layer of the image, a band of block rows per
+		// thread: BC6H to floats, the others to 8-bit pixels. The slices of a volume follow each other in its surface.
+		bcn::Format blockFormat;
+		if (image.get_block_format(blockFormat))
+		{
+			d = bcn::channels(blockFormat);
+			type = bcn::isFloat(blockFormat) ? Type::FLOAT : Type::UBYTE;
+			*pixels = new unsigned char[totalBytes()];
+			const size_t sliceBytes = bcn::surfaceBytes(blockFormat, w, h);
+			for (int i = 0; i < layers_; ++i)
+			{
+				const nv_dds::CTexture& surface = image.get_surface(layout_ == Layout::VOLUME ? 0 : i);
+				const size_t offset = layout_ == Layout::VOLUME ? i * sliceBytes : 0;
+				if (!bcn::decode(blockFormat, (const uint8_t*)surface + offset, surface.get_size() - offset, w, h,
+					*pixels + i * layerBytes()))
+				{
+					delete[] *pixels;
+					*pixels = nullptr;
+					throw std::exception("Truncated .dds block data");
+				}
+			}
+			image.clear();
+			return;
+		}
+
+		// the type follows from the bytes each value takes
+		const size_t values = (size_t)w * h * d * layers_;
+		type = Type::UBYTE;
+		if (dataBytes / values == 4)
+		{
+			type = Type::FLOAT;
+		}
+		else if (dataBytes / values == 2)
+		{
+			type = Type::USHORT;
+		}
+		image.clear();
+		if (dataBytes != totalBytes())
+		{
+			delete[] data;
+			throw std::exception("Cannot handle this .dds pixel format");
+		}
+		*pixels = data;
+	}
+	void Image::writeDds(std::string filepath, unsigned char* pixels, int& w, int& h, int& d, Type& type, const WriteOptions& options)
+	{
+		if (layout_ == Layout::CUBEMAP && layers_ != 6)
+			throw std::exception("A .dds cubemap needs 6 faces");
+		if (layout_ == Layout::VOLUME && options.ddsMipmaps != MipFilter::NONE)
+			throw std::exception("Cannot make mipmaps of .dds volume textures");
+
+		const bool compressed = options.ddsCompression != DdsCompression::NONE;
+		if (compressed && type != Type::UBYTE)
+			throw std::exception("DDS block compression needs an 8-bit image");
+		const bcn::Format format = options.ddsCompression == DdsCompression::BC1 ? bcn::Format::BC1 :
+			options.ddsCompression == DdsCompression::BC3 ? bcn::Format::BC3 : bcn::Format::BC7;
+		const bcn::Quality quality = options.ddsQuality <= 0 ? bcn::Quality::FAST :
+			options.ddsQuality == 1 ? bcn::Quality::NORMAL : bcn::Quality::BEST;
+
+		// DDS rows run top to bottom. Bottom-up images are compressed as they are and their blocks flipped after,
+		// which moves a quarter to an eighth of the bytes flipping the pixels would. BC7 blocks cannot be flipped
+		// that way, nor can heights above 4 that are not a multiple of 4, and images less high than a block would
+		// be compressed with their padding rows on the wrong side. Those images, and uncompressed ones, have their
+		// pixels flipped first.
+		if (bottomUp_ && (!compressed || format == bcn::Format::BC7 || h % 4 != 0))
+			setBottomUp(false);
+
+		// Mipmaps and blocks, which the surfaces below are views of. Uncompressed faces, slices and layers are
+		// written straight from our pixels.
+		std::vector<std::vector<unsigned char>> storage;
+		auto view = [&](unsigned char* level, int lw, int lh, int slices, nv_dds::CSurface& surface) {
+			if (!compressed)
+			{
+				surface.create_view(lw, lh, slices, (unsigned int)((size_t)lw * lh * d * byteSize() * slices), level);
+				return;
+			}
+			// The mipmaps of a bottom-up image are bottom-up as well. For the same reasons, those with heights
+			// other than 1 that are not a multiple of 4 are compressed from a flipped copy of their pixels.
+			const size_t sliceBytes = bcn::surfaceBytes(format, lw, lh);
+			const size_t rowBytes = (size_t)lw * d;
+			const bool flipPixels = bottomUp_ && lh % 4 != 0 && lh != 1;
+			std::vector<unsigned char> flipped(flipPixels ? rowBytes * lh : 0);
+			storage.emplace_back(sliceBytes * slices);
+			for (int i = 0; i < slices; ++i)
+			{
+				const unsigned char* slice = level + (size_t)i * lw * lh * d;
+				if (flipPixels)
+				{
+					for (int y = 0; y < lh; ++y)
+						memcpy(&flipped[y * rowBytes], slice + (lh - 1 - y) * rowBytes, rowBytes);
+					slice = flipped.data();
+				}
+				unsigned char* blocks = storage.back().data() + i * sliceBytes;
+				if (!bcn::encode(format, slice, lw, lh, d, blocks, quality))
+					throw std::exception("Cannot block compress this image");
+				if (bottomUp_ && !flipPixels)
+					nv_dds::CDDSImage::flip_blocks(format, blocks, lw, lh);
+			}
+			surface.create_view(lw, lh, slices, (unsigned int)storage.back().size(), storage.back().data());
+		};
+
+		// A volume is one surface of all its slices; the others have a surface per face or layer, each followed by
+		// its mipmaps, every level filtered from the one above it, down to 1x1.
+		const int surfaces = layout_ == Layout::VOLUME ? 1 : layers_;
+		const int slices = layout_ == Layout::VOLUME ? layers_ : 1;
+		std::deque<nv_dds::CTexture> textures(surfaces);
+		for (int i = 0; i < surfaces; ++i)
+		{
+			unsigned char* above = pixels + i * layerBytes();
+			view(above, w, h, slices, textures[i]);
+			if (options.ddsMipmaps == MipFilter::NONE)
+				continue;
+			const mipmap::Filter filter = options.ddsMipmaps == MipFilter::BOX ? mipmap::Filter::BOX : mipmap::Filter::KAISER;
+			for (int mw = w, mh = h; mw > 1 || mh > 1; mw = mipmap::nextSize(mw), mh = mipmap::nextSize(mh))
+			{
+				storage.emplace_back((size_t)mipmap::nextSize(mw) * mipmap::nextSize(mh) * d * byteSize());
+				mipmap::downsample(filter, above, mw, mh, d, byteSize(), storage.back().data());
+				above = storage.back().data();
+				nv_dds::CSurface level;
+				view(above, mipmap::nextSize(mw), mipmap::nextSize(mh), 1, level);
+				textures[i].add_mipmap(level);
+			}
+		}
+
+		unsigned int fmt = 0;
+		unsigned int components = d;
+		if (compressed)
+		{
+			fmt = nv_dds::CDDSImage::gl_format(format);
+			components = bcn::channels(format);
+		}
+		else
+		{
+			switch (d) {
+			case 1:
+				fmt = 6403;//GL_RED
+				break;
+			case 3:
+				fmt = GL_RGB;
+				break;
+			case 4:
+				fmt = GL_RGBA;
+				break;
+			}
+		}
+
+		nv_dds::CDDSImage ddsimage;
+		switch (layout_) {
+		case Layout::FLAT:
+			ddsimage.create_textureFlat(fmt, components, textures[0]);
+			break;
+		case Layout::CUBEMAP:
+			ddsimage.create_textureCubemap(fmt, components, textures[0], textures[1], textures[2], textures[3], textures[4], textures[5]);
+			break;
+		case Layout::VOLUME:
+			if (layers_ > 1)
+				ddsimage.create_texture3D(fmt, components, textures[0]);
+			else
+				ddsimage.create_textureFlat(fmt, components, textures[0]);
+			break;
+		case Layout::ARRAY:
+			ddsimage.create_textureArray(fmt, components, textures);
+			break;
+		}
+		// the surfaces are top to bottom already
+		ddsimage.save(filepath, false);
+		ddsimage.clear();
+	}
+
+	void Image::readExr(std::string filepath, unsigned char** pixels, int& w, int& h, int& d, Type& type)
+	{
+		// The file is mapped rather than read, tinyexr decodes it from there into a plane per channel, and the
+		// planes are interleaved straight into our pixels as RGBA floats.
+		MappedFile file;
+		if (!file.open(filepath))
+			throw std::exception("Could not open .exr file");
+
+		EXRVersion version;
+		EXRHeader header;
+		EXRImage image;
+		InitEXRHeader(&header);
+		InitEXRImage(&image);
+		const char* err = nullptr;
+		int ret = ParseEXRVersionFromMemory(&version, file.data(), file.size());
+		if (ret == TINYEXR_SUCCESS)
+			ret = ParseEXRHeaderFromMemory(&header, &version, file.data(), file.size(), &err);
+		if (ret == TINYEXR_SUCCESS)
+		{
+			// half channels are read as floats
+			for (int i = 0; i < header.num_channels; ++i)
+				if (header.pixel_types[i] == TINYEXR_PIXELTYPE_HALF)
+					header.requested_pixel_types[i] = TINYEXR_PIXELTYPE_FLOAT;
+			ret = LoadEXRImageFromMemory(&image, &header, file.data(), file.size(), &err);
+		}
+
+		// The channels of R, G, B and A, picked as LoadEXRFromMemory() does: a single channel is gray and fills all
+		// four, else R, G and B have to be there, and alpha is 1 without A.
+		const char* names[4] = { "R", "G", "B", "A" };
+		int channels[4] = { -1, -1, -1, -1 };
+		if (ret == TINYEXR_SUCCESS)
+		{
+			for (int c = 0; c < header.num_channels; ++c)
+				for (int k = 0; k < 4; ++k)
+					if (header.num_channels == 1 || strcmp(header.channels[c].name, names[k]) == 0)
+						channels[k] = c;
+		}
+		if (ret != TINYEXR_SUCCESS || channels[0] < 0 || channels[1] < 0 || channels[2] < 0)
+		{
+			if (err)
+			{
+				std::cerr << err << std::endl;
+				FreeEXRErrorMessage(err);
+			}
+			FreeEXRImage(&image);
+			FreeEXRHeader(&header);
+			throw std::exception("Could not load .exr");
+		}
+
+		w = image.width;
+		h = image.height;
+		d = 4; // assume RGBA float data
+		type = Type::FLOAT;
+		*pixels = new unsigned char[totalBytes()];
+		float* out = reinterpret_cast<float*>(*pixels);
+
+		// Copies the planes of a tw x th block of the image at (x0, y0) into our pixels a row at a time, which stays
+		// in cache while each channel is spread across it.
+		auto interleave = [&](unsigned char** planes, int x0, int y0, int tw, int th) {
+			const int cols = std::min(tw, w - x0);
+			for (int y = 0; y < th && y0 + y < h; ++y)
+			{
+				float* row = out + ((size_t)(y0 + y) * w + x0) * 4;
+				for (int k = 0; k < 4; ++k)
+				{
+					const int c = channels[k];
+					if (c < 0)
+					{
+						for (int x = 0; x < cols; ++x)
+							row[4 * x + k] = 1.0f;
+						continue;
+					}
+					const unsigned char* plane = planes[c] + (size_t)y * tw * 4;
+					for (int x = 0; x < cols; ++x)
+					{
+						float value;
+						if (header.requested_pixel_types[c] == TINYEXR_PIXELTYPE_UINT)
+						{
+							uint32_t u;
+							memcpy(&u, plane + 4 * x, 4);
+							value = (float)u;
+						}
+						else
+						{
+							memcpy(&value, plane + 4 * x, 4);
+						}
+						row[4 * x + k] = value;
+					}
+				}
+			}
+		};
+		if (header.tiled)
+		{
+			for (int i = 0; i < image.num_tiles; ++i)
+			{
+				const EXRTile& tile = image.tiles[i];
+				interleave(tile.images, tile.offset_x * header.tile_size_x, tile.offset_y * header.tile_size_y,
+					header.tile_size_x, header.tile_size_y);
+			}
+		}
+		else
+		{
+			interleave(image.images, 0, 0, w, h);
+		}
+
+		FreeEXRImage(&image);
+		FreeEXRHeader(&header);
+	}
+
+	void Image::writeExr(std::string filepath, unsigned char* pixels, int& w, int& h, int& d, Type& type)
+	{
+		const char* err = "\0";
+		float* float_pixels = new float[w * h * d];
+		memcpy(float_pixels, pixels, w * h * d * FLOAT_SIZE);
+		auto ret = SaveEXR(float_pixels, w, h, d, false, filepath.c_str(), &err);
+		if (ret)
+		{
+			std::cerr << err << std::endl;
+		}
+	}
+
+	void Image::readGif(std::string filepath, unsigned char** pixels, int& w, int& h, int& d, Type& type)
+	{
+		gif::gd_GIF* gif;
+		gif = gif::gd_open_gif(filepath.c_str());
+		if (!gif) {
+			throw std::exception("Could not open gif file");
+		}
+
+		w = gif->width;
+		h = gif->height;
+		d = 3; // Assumes 3-channel RGB encoding of data, which is standard for .gif images.
+
+		switch (gif->depth)
+		{
+		case 16:
+			type = Type::USHORT;
+			break;
+		case 32:
+			type = Type::FLOAT;
+			break;
+		default:
+			type = Type::UBYTE;
+			break;
+		}
+
+		// Get only the first frame of the .gif file, although this could be called repeatedly to get all of them.
+		if (gd_get_frame(gif) == -1)
+		{
+			gif::gd_close_gif(gif);
+			throw std::exception("Could not load .gif data");
+		}
+		*pixels = new unsigned char[totalBytes()];
+		gd_render_frame(gif, *pixels);
+		gif::gd_close_gif(gif);
+	}
+
+	// 8 bits per channel copy of USHORT or FLOAT pixels (floats clamped to [0, 1]) for codecs that only store 8 bits.
+	static const unsigned char* ubytePixels(const unsigned char* pixels, size_t count, Type type, std::vector<unsigned char>& buffer)
+	{
+		if (type == Type::UBYTE)
+			return pixels;
+		buffer.resize(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (type == Type::USHORT)
+			{
+				uint16_t v;
+				memcpy(&v, pixels + i * 2, 2);
+				buffer[i] = (unsigned char)(v >> 8);
+			}
+			else
+			{
+				float v;
+				memcpy(&v, pixels + i * 4, 4);
+				buffer[i] = (unsigned char)(std::min(std::max(v, 0.0f), 1.0f) * 255.0f + 0.5f);
+			}
+		}
+		return buffer.data();
+	}
+
+	static int gifDitherOf(GifDither dither, bool animated)
+	{
+		switch (dither)
+		{
+		case GifDither::DEFAULT:
+			return animated ? GQ_DITHER_ORDERED : GQ_DITHER_FS;
+		case GifDither::FLOYD_STEINBERG:
+			return GQ_DITHER_FS;
+		case GifDither::ORDERED:
+			return GQ_DITHER_ORDERED;
+		default:
+			return GQ_DITHER_NONE;
+		}
+	}
+
+	void Image::writeGif(std::string filepath, unsigned char* pixels, int& w, int& h, int& d, Type& type, const WriteOptions& options)
+	{
+		if (w < 1 || h < 1 || w > 0xFFFF || h > 0xFFFF)
+			throw std::invalid_argument("GIF images must be 1 to 65535 pixels wide and high");
+		if (d < 1 || d > 4)
+			throw std::invalid_argument("GIF images can only be written from 1 to 4 channels");
+		std::vector<unsigned char> converted;
+		const unsigned char* px = ubytePixels(pixels, (size_t)w * h * d, type, converted);
+
+		// Reduce the image to a palette of at most options.gifColors colors, the only kind of image GIF stores.
+		std::unique_ptr<gif::gq_Quantizer, void (*)(gif::gq_Quantizer*)> quantizer(gif::gq_new(options.gifColors), gif::gq_free);
+		if (!quantizer)
+			throw std::bad_alloc();
+		gif::gq_add_pixels(quantizer.get(), px, (size_t)w * h, d);
+		uint8_t palette[256 * 3];
+		int transIndex = -1;
+		int numColors = gif::gq_build_palette(quantizer.get(), palette, &transIndex);
+		std::vector<uint8_t> indices((size_t)w * h);
+		if (numColors < 0 || gif::gq_map(quantizer.get(), px, w, h, d, gifDitherOf(options.gifDither, false), indices.data()))
+			throw std::bad_alloc();
+
+		gif::CGIF_Config gConfig;
+		memset(&gConfig, 0, sizeof(gif::CGIF_Config));
+		gConfig.width = (uint16_t)w;
+		gConfig.height = (uint16_t)h;
+		gConfig.numGlobalPaletteEntries = (uint16_t)numColors;
+		gConfig.pGlobalPalette = palette;
+		gConfig.path = filepath.c_str();
+		gif::CGIF_FrameConfig fConfig;
+		memset(&fConfig, 0, sizeof(gif::CGIF_FrameConfig));
+		fConfig.pImageData = indices.data();
+		if (transIndex >= 0)
+		{
+			fConfig.attrFlags |= CGIF_FRAME_ATTR_HAS_ALPHA;
+			fConfig.transIndex = (uint8_t)transIndex;
+		}
+
+		gif::CGIF* pGIF = gif::cgif_newgif(&gConfig);
+		if (!pGIF)
+			throw std::exception("Could not open file");
+		auto err = gif::cgif_addframe(pGIF, &fConfig);
+		auto closeErr = gif::cgif_close(pGIF);
+		if (err || closeErr)
+			throw std::exception(("Could not write .gif file. Code: " + std::to_string(err ? err : closeErr)).c_str());
+	}
+
+	static int writeToStream(void* context, const uint8_t* data, const size_t size)
+	{
+		auto out = (std::ofstream*)context;
+		out->write((const char*)data, size);
+		return out->good() ? 0 : 1;
+	}
+
+	// Animated GIF writer behind AnimatedImage::write(). All frames share one palette. Frames go through the pool in
+	// batches: they are mapped to the palette and LZW-compressed in parallel, and written in order.
+	static void writeGifAnimation(std::string filepath, const std::vector<AnimationFrame>& frames, int w, int h, int d,
+		Type type, int loopCount, const WriteOptions& options)
+	{
+		if (w < 1 || h < 1 || w > 0xFFFF || h > 0xFFFF)
+			throw std::invalid_argument("GIF images must be 1 to 65535 pixels wide and high");
+		if (d < 1 || d > 4)
+			throw std::invalid_argument("GIF images can only be written from 1 to 4 channels");
+		if (frames.empty())
+			throw std::invalid_argument("Animation without frames");
+		for (auto& frame : frames)
+			if (!frame.pixels)
+				throw std::invalid_argument("Animation frame without pixels");
+		const size_t area = (size_t)w * h;
+
+		// One palette for every frame, so that frames can store only the pixels that changed. A transparent entry
+		// marks the pixels that stay as they were. Frames with alpha bring their own, which the quantizer keeps room
+		// for; for the others the colors are quantized to one less than the palette holds and the entry is added after.
+		// Frames with alpha that turn out to have no transparent pixels are quantized again if the entry does not fit.
+		// That leaves at least 2 colors and the transparent one.
+		int colors = std::min(std::max(options.gifColors, 3), 256);
+		std::unique_ptr<gif::gq_Quantizer, void (*)(gif::gq_Quantizer*)> quantizer(nullptr, gif::gq_free);
+		uint8_t palette[256 * 3];
+		int transIndex = -1;
+		int numColors = 0;
+		std::vector<unsigned char> converted;
+		for (int maxColors = d != 2 && d != 4 ? colors - 1 : colors; ; maxColors = colors - 1)
+		{
+			quantizer.reset(gif::gq_new(maxColors));
+			if (!quantizer)
+				throw std::bad_alloc();
+			for (auto& frame : frames)
+				gif::gq_add_pixels(quantizer.get(), ubytePixels(frame.pixels, area * d, type, converted), area, d);
+			transIndex = -1;
+			numColors = gif::gq_build_palette(quantizer.get(), palette, &transIndex);
+			if (numColors < 0)
+				throw std::bad_alloc();
+			if (transIndex >= 0 || numColors < colors)
+				break;
+		}
+		const bool hasAlpha = transIndex >= 0;
+		if (!hasAlpha)
+		{
+			transIndex = numColors++;
+			palette[transIndex * 3 + 0] = palette[transIndex * 3 + 1] = palette[transIndex * 3 + 2] = 0;
+		}
+		// Frames are mapped in parallel, which needs the whole color lookup table up front.
+		if (ThreadPool::global().size() > 1)
+			gif::gq_fill_lut(quantizer.get());
+
+		std::ofstream out(filepath, std::ios::binary);
+		if (!out)
+			throw std::exception("Could not open file");
+		gif::CGIFRaw_Config gConfig;
+		memset(&gConfig, 0, sizeof(gif::CGIFRaw_Config));
+		gConfig.pWriteFn = writeToStream;
+		gConfig.pContext = &out;
+		gConfig.pGCT = palette;
+		gConfig.sizeGCT = (uint16_t)numColors;
+		gConfig.width = (uint16_t)w;
+		gConfig.height = (uint16_t)h;
+		gConfig.attrFlags = CGIF_RAW_ATTR_IS_ANIMATED;
+		// loopCount is how many times the animation plays, the NETSCAPE extension counts the repeats.
+		if (loopCount == 1)
+			gConfig.attrFlags |= CGIF_RAW_ATTR_NO_LOOP;
+		else
+			gConfig.numLoops = (uint16_t)std::min(std::max(loopCount - 1, 0), 0xFFFF);
+		std::unique_ptr<gif::CGIFRaw, void (*)(gif::CGIFRaw*)> pGIF(gif::cgif_raw_newgif(&gConfig), [](gif::CGIFRaw* p) { gif::cgif_raw_close(p); });
+		if (!pGIF)
+			throw std::exception("Could not write .gif file");
+
+		struct GifFrame
+		{
+			int x = 0, y = 0, w = 0, h = 0; // w == 0: same as the frame before
+			std::vector<uint8_t> indices;
+			int delayMs = 0;
+			gif::CGIFRaw_EncodedFrame encoded = { nullptr, 0 };
+		};
+		auto encode = [&](GifFrame& f, gif::CGIFRaw_Workspace* work)
+		{
+			gif::CGIFRaw_FrameConfig fConfig;
+			memset(&fConfig, 0, sizeof(gif::CGIFRaw_FrameConfig));
+			fConfig.pImageData = f.indices.data();
+			fConfig.left = (uint16_t)f.x;
+			fConfig.top = (uint16_t)f.y;
+			fConfig.width = (uint16_t)f.w;
+			fConfig.height = (uint16_t)f.h;
+			fConfig.delay = (uint16_t)std::min((f.delayMs + 5) / 10, 0xFFFF);
+			fConfig.attrFlags = CGIF_RAW_FRAME_ATTR_HAS_TRANS;
+			fConfig.transIndex = (uint8_t)transIndex;
+			// Frames with transparent pixels have to clear what was under them, the others build on the frame before.
+			fConfig.disposalMethod = hasAlpha ? DISPOSAL_METHOD_BACKGROUND : DISPOSAL_METHOD_LEAVE;
+			auto err = gif::cgif_raw_encodeframe(pGIF.get(), &fConfig, work, &f.encoded);
+			if (err != gif::CGIF_OK)
+				throw std::exception(("Could not write .gif file. Code: " + std::to_string(err)).c_str());
+		};
+		// The LZW encoder keeps its buffers from frame to frame, one set per thread.
+		std::vector<std::unique_ptr<gif::CGIFRaw_Workspace, void (*)(gif::CGIFRaw_Workspace*)>> workspaces;
+		for (unsigned t = 0; t < ThreadPool::global().size(); ++t)
+		{
+			workspaces.emplace_back(gif::cgif_raw_newworkspace(), gif::cgif_raw_freeworkspace);
+			if (!workspaces.back())
+				throw std::bad_alloc();
+		}
+		std::vector<GifFrame> pending; // encoded, or waiting to know its delay
+		auto flush = [&](size_t count)
+		{
+			try
+			{
+				std::atomic<size_t> next{ 0 };
+				ThreadPool::global().parallelFor(0, workspaces.size(), [&](size_t t)
+				{
+					size_t i;
+					while ((i = next.fetch_add(1)) < count)
+						encode(pending[i], workspaces[t].get());
+				});
+			}
+			catch (...)
+			{
+				for (size_t i = 0; i < count; ++i)
+					free(pending[i].encoded.pData);
+				throw;
+			}
+			gif::cgif_result err = gif::CGIF_OK;
+			for (size_t i = 0; i < count; ++i)
+				err = gif::cgif_raw_writeframe(pGIF.get(), &pending[i].encoded);
+			pending.erase(pending.begin(), pending.begin() + count);
+			if (err != gif::CGIF_OK)
+				throw std::exception(("Could not write .gif file. Code: " + std::to_string(err)).c_str());
+		};
+
+		// canvas[0] holds the frame before the batch, canvas[i + 1] frame i of the batch, mapped to the palette.
+		const size_t batch = (size_t)ThreadPool::global().size() * 2;
+		std::vector<std::vector<uint8_t>> canvas(batch + 1);
+		std::vector<GifFrame> diffs(batch);
+		for (size_t start = 0; start < frames.size(); start += batch)
+		{
+			size_t count = std::min(batch, frames.size() - start);
+			ThreadPool::global().parallelFor(0, count, [&](size_t i)
+			{
+				std::vector<unsigned char> buffer;
+				canvas[i + 1].resize(area);
+				if (gif::gq_map(quantizer.get(), ubytePixels(frames[start + i].pixels, area * d, type, buffer), w, h, d,
+					gifDitherOf(options.gifDither, true), canvas[i + 1].data()))
+					throw std::bad_alloc();
+			});
+			// Only the rectangle that changed is stored, with the pixels in it that did not change transparent.
+			ThreadPool::global().parallelFor(0, count, [&](size_t i)
+			{
+				const uint8_t* cur = canvas[i + 1].data();
+				GifFrame& f = diffs[i];
+				f = GifFrame();
+				if (start + i == 0)
+				{
+					f.w = w;
+					f.h = h;
+					f.indices.assign(cur, cur + area);
+					return;
+				}
+				const uint8_t* prev = canvas[i].data();
+				int x0 = w, x1 = -1, y0 = h, y1 = -1;
+				for (int y = 0; y < h; ++y)
+				{
+					const uint8_t* a = prev + (size_t)y * w;
+					const uint8_t* b = cur + (size_t)y * w;
+					if (!memcmp(a, b, w))
+						continue;
+					int l = 0, r = w - 1;
+					while (a[l] == b[l])
+						++l;
+					while (a[r] == b[r])
+						--r;
+					x0 = std::min(x0, l);
+					x1 = std::max(x1, r);
+					if (y0 == h)
+						y0 = y;
+					y1 = y;
+				}
+				if (x1 < 0)
+					return;
+				if (hasAlpha)
+				{
+					f.w = w;
+					f.h = h;
+					f.indices.assign(cur, cur + area);
+					return;
+				}
+				f.x = x0;
+				f.y = y0;
+				f.w = x1 - x0 + 1;
+				f.h = y1 - y0 + 1;
+				f.indices.resize((size_t)f.w * f.h);
+				uint8_t* o = f.indices.data();
+				for (int y = y0; y <= y1; ++y)
+					for (int x = x0; x <= x1; ++x)
+					{
+						size_t k = (size_t)y * w + x;
+						*o++ = cur[k] == prev[k] ? (uint8_t)transIndex : cur[k];
+					}
+			});
+			// A frame that is the same as the one before only adds to its delay.
+			for (size_t i = 0; i < count; ++i)
+			{
+				int delayMs = std::max(frames[start + i].delayMs, 0);
+				if (diffs[i].w == 0 && (pending.back().delayMs + delayMs + 5) / 10 <= 0xFFFF)
+				{
+					pending.back().delayMs += delayMs;
+					continue;
+				}
+				if (diffs[i].w == 0)
+				{
+					// The delay would overflow: show the same frame again.
+					diffs[i].w = w;
+					diffs[i].h = h;
+					diffs[i].indices = canvas[i + 1];
+				}
+				diffs[i].delayMs = delayMs;
+				pending.push_back(std::move(diffs[i]));
+			}
+			// The last frame may still get the delay of the frames in the next batch.
+			flush(pending.size() - 1);
+			std::swap(canvas[0], canvas[count]);
+		}
+		flush(pending.size());
+		auto err = gif::cgif_raw_close(pGIF.release());
+		out.close();
+		if (err != gif::CGIF_OK || !out)
+			throw std::exception(("Could not write .gif file. Code: " + std::to_string(err)).c_str());
+	}
+
+	typedef unsigned char RGBE[4];
+#define R			0
+#define G			1
+#define B			2
+#define E			3
+
+#define  MINELEN	8				// minimum scanline length for encoding
+#define  MAXELEN	0x7fff			// maximum scanline length for encoding
+	int invConvertComponent(int expo, float val)
+	{
+		float d = (float)pow(0.5f, float(expo));
+		return unsigned char(val * 256.0f * d);
+	}
+
+	float convertComponent(int expo, int val)
+	{
+		float v = val / 256.0f;
+		float d = (float)pow(2, expo);
+		return v * d;
+	}
+
+	void workOnRGBE(RGBE* scan, int len, float* cols)
+	{
+		while (len-- > 0) {
+			int expo = scan[0][E] - 128;
+			cols[0] = convertComponent(expo, scan[0][R]);
+			cols[1] = convertComponent(expo, scan[0][G]);
+			cols[2] = convertComponent(expo, scan[0][B]);
+			cols[3] = float(scan[0][E]);
+			cols += 4;
+			scan++;
+		}
+	}
+
+	bool oldDecrunchHDR(RGBE* scanline, int len, FILE* file)
+	{
+		int i;
+		int rshift = 0;
+
+		while (len > 0) {
+			scanline[0][R] = fgetc(file);
+			scanline[0][G] = fgetc(file);
+			scanline[0][B] = fgetc(file);
+			scanline[0][E] = fgetc(file);
+			if (feof(file))
+				return false;
+
+			if (scanline[0][R] == 1 &&
+				scanline[0][G] == 1 &&
+				scanline[0][B] == 1) {
+				for (i = scanline[0][E] << rshift; i > 0; i--) {
+					memcpy(&scanline[0][0], &scanline[-1][0], 4);
+					scanline++;
+					len--;
+				}
+				rshift += 8;
+			}
+			else {
+				scanline++;
+				len--;
+				rshift = 0;
+			}
+		}
+		return true;
+	}
+
+	bool decrunchHDR(RGBE* scanline, int len, FILE* file)
+	{
+		int  i, j;
+
+		if (len < MINELEN || len > MAXELEN)
+			return oldDecrunchHDR(scanline, len, file);
+
+		i = fgetc(file);
+		if (i != 2) {
+			fseek(file, -1, SEEK_CUR);
+			return oldDecrunchHDR(scanline, len, file);
+		}
+
+		scanline[0][G] = fgetc(file);
+		scanline[0][B] = fgetc(file);
+		i = fgetc(file);
+
+		if (scanline[0][G] != 2 || scanline[0][B] & 128) {
+			scanline[0][R] = 2;
+			scanline[0][E] = i;
+			return oldDecrunchHDR(scanline + 1, len - 1, file);
+		}
+
+		// read each component
+		for (i = 0; i < 4; i++) {
+			for (j = 0; j < len; ) {
+				unsigned char code = fgetc(file);
+				if (code > 128) { // run
+					code &= 127;
+					unsigned char val = fgetc(file);
+					while (code--)
+						scanline[j++][i] = val;
+				}
+				else {	// non-run
+					while (code--)
+						scanline[j++][i] = fgetc(file);
+				}
+			}
+		}
+
+		return feof(file) ? false : true;
+	}
+
+
+	void Image::readHdr(std::string filepath, unsigned char** pixels, int& w_, int& h_, int& d_, Type& type)
+	{
+		int i;
+		char str[200];
+		FILE* file;
+
+		file = fopen(filepath.c_str(), "rb");
+		if (!file)
+			throw std::exception("Cannot open file");
+
+		fread(str, 10, 1, file);
+		if (memcmp(str, "#?RADIANCE", 10)) {
+			fclose(file);
+			throw std::exception("Invalid file format");
+		}
+
+		fseek(file, 1, SEEK_CUR);
+
+		char cmd[200];
+		i = 0;
+		char c = 0, oldc;
+		while (true) {
+			oldc = c;
+			c = fgetc(file);
+			if (c == 0xa && oldc == 0xa)
+				break;
+			cmd[i++] = c;
+		}
+
+		char reso[200];
+		i = 0;
+		while (true) {
+			c = fgetc(file);
+			reso[i++] = c;
+			if (c == 0xa)
+				break;
+		}
+
+		int w, h;
+		if (!sscanf(reso, "-Y %ld +X %ld", &h, &w)) {
+			fclose(file);
+			throw std::exception("Invalid file format");
+		}
+
+		w_ = w;
+		h_ = h;
+		d_ = 4; // All .hdr files are 4-channel RGBE data w/ alpha component == exposure
+		float* floatPixels = new float[w * h * d_];
+
+		RGBE* scanline = new RGBE[w];
+		if (!scanline) {
+			fclose(file);
+			throw std::exception("Invalid file format");
+		}
+
+		// convert image and copy over float data.
+		type = Type::FLOAT;
+		*pixels = new unsigned char[totalBytes()];
+		unsigned int lineCount = 0;
+		for (int y = h - 1; y >= 0; y--) {
+			if (decrunchHDR(scanline, w, file) == false)
+				break;
+			workOnRGBE(scanline, w, floatPixels);
+			memcpy(*pixels + lineCount, floatPixels, w * d_ * FLOAT_SIZE);
+			floatPixels += w * d_;
+			lineCount += w * d_ * FLOAT_SIZE;
+		}
+		
+		// Cleanup.
+		delete[] scanline;
+		fclose(file);
+	}
+
+	void Image::writeHdr(std::string filepath, unsigned char* pixels, int& w, int& h, int& d, Type& type)
+	{
+		if (d != 4)
+		{
+			throw std::exception("HDR data must contain a 4th channel of exposure values");
+		}
+
+		std::ofstream ofile(filepath.c_str(), std::ios::out | std::ios::binary);
+		if (!ofile.is_open())
+			throw std::exception("Cannot open output file.");
+
+		// Write hdr header.
+		ofile << "#?RADIANCE" << char(0x0A) << "SOFTWARE=GEGL" << char(0x0A) << "FORMAT=32-bit_rle_rgbe" << char(0x0A) << char(0x0A) << "-Y " << std::to_string(h) << " +X " << std::to_string(w) << char(0x0A);
+
+		unsigned int counter = 0;
+		float px;
+		float expo2;
+		for (unsigned int i = 0; i < w * h; ++i) // assumes size of float == 4 bytes
+		{
+			memcpy(&expo2, &pixels[counter+(3 * FLOAT_SIZE)], FLOAT_SIZE);
+			int expo = int(expo2) - 128;
+			for (unsigned int j = 0; j < d; ++j)
+			{
+				if (j == 3) // Save exposure float
+				{
+					ofile << unsigned char(expo+128);
+				}
+				else // For RGB data, convert back to linear value and write to file.
+				{
+					px = 0.0f;
+					memcpy(&px, &pixels[counter], FLOAT_SIZE);
+					ofile << (unsigned char)invConvertComponent(px,expo);
+					
+				}
+				counter+=4; // assumes size of float == 4 bytess
+			}
+		}
+
+		ofile.flush();
+		ofile.close();
+	}
+
+	void Image::readJpg(std::string filepath, unsigned char** pixels, int& w, int& h, int& d, Type& type)
+	{
+		// Open file.
+		FILE* f = fopen(filepath.c_str(), "rb");
+		fseek(f, 0, SEEK_END);
+		int size = (int)ftell(f);
+		auto temparr = new unsigned char[size];
+		fseek(f, 0, SEEK_SET);
+		size = (int)fread(temparr, 1, size, f);
+		fclose(f);
+
+		// Init jpeg lib and decode bytes.
+		njInit();
+		if (njDecode(temparr, size)) {
+			delete[] temparr;
+			throw std::exception("Error decoding the input file.\n");
+		}
+
+		// Copy results to local vars.
+		d = 3;
+		w = njGetWidth();
+		h = njGetHeight();
+		*pixels = new unsigned char[totalBytes()];
+		memcpy(*pixels, njGetImage(), totalBytes());
+
+		// Cleanup.
+		delete[] temparr;
+		njDone();
+	}
+
+	void Image::writeJpg(std::string filepath, unsigned char* pixels, int& w, int& h, int& d, Type& type)
+	{
+		tje_encode_to_file(filepath.c_str(), w, h, d, pixels);
+	}
+
+#define PNG_RGBA_PIXEL_LIMIT (0x1000000)
+
+	static int png_rgba_pixel_limit(unsigned int w, unsigned int h) {
+		double da;
+		/* assert(w != 0 && h != 0); */
+		if (w > PNG_RGBA_PIXEL_LIMIT || h > PNG_RGBA_PIXEL_LIMIT)
+			return (1); /* since both (w) and (h) are non-zero. */
+		/* since an IEEE-754 double has a 53 bit mantissa, it can
+		* represent the maximum area: (w * h == 2^48) exactly. */
+		da = ((double)w) * ((double)h);
+		if (da > ((double)PNG_RGBA_PIXEL_LIMIT))
+			return (1);
+		return (0); /* the PNG image is within the pixel limit. */
+	}
+
+#ifndef IMAGECODECS_NO_LIBPNG
+	// Checks the header and sets the libpng transforms of PngStreamDecoder, which give the same layout as the built-in
+	// decoder of readPng(): 8 or 16 bits per channel (16-bit in native byte order), palettes expanded, native channel
+	// count unless RGBA was requested.
+	static void preparePngRead(png_structp png_ctx, png_infop info_ctx, const ReadOptions& options) {
+		png_uint_32 img_width = png_get_image_width(png_ctx, info_ctx);
+		png_uint_32 img_height = png_get_image_height(png_ctx, info_ctx);
+
+		if (img_width == 0 || img_height == 0)
+			png_error(png_ctx, "zero area PNG image");
+		if (png_rgba_pixel_limit(img_width, img_height))
+			png_error(png_ctx, "PNG image exceeds pixel limits");
+
+		png_byte img_depth = png_get_bit_depth(png_ctx, info_ctx);
+		png_byte img_color_type = png_get_color_type(png_ctx, info_ctx);
+
+		/* ignored image compression and filtering. */
+		/* keep 16-bit color channels, expand the ones below 8 bits: */
+		if (img_color_type == PNG_COLOR_TYPE_PALETTE)
+			png_set_palette_to_rgb(png_ctx);
+		else if (img_depth < 8)
+			png_set_expand_gray_1_2_4_to_8(png_ctx);
+		/* a tRNS chunk becomes a real alpha channel: */
+		if (png_get_valid(png_ctx, info_ctx, PNG_INFO_tRNS))
+			png_set_tRNS_to_alpha(png_ctx);
+		/* PNG stores 16-bit values big endian, let libpng swap them while it unfilters each row: */
+		if (img_depth == 16)
+			png_set_swap(png_ctx);
+		/* grey and RGB stay at their native channel count unless RGBA was asked for: */
+		if (options.channels == 4)
+		{
+			if (img_color_type == PNG_COLOR_TYPE_GRAY || img_color_type == PNG_COLOR_TYPE_GRAY_ALPHA)
+				png_set_gray_to_rgb(png_ctx);
+			png_set_add_alpha(png_ctx, img_depth == 16 ? 0xffff : 0xff, PNG_FILLER_AFTER);
+		}
+		png_set_interlace_handling(png_ctx);
+	}
+#endif
+
+	unsigned int accessArray3D(unsigned int r, unsigned int c, unsigned int d, unsigned int rows, unsigned int cols, unsigned int depth) {
+		unsigned int idx = ((r * cols + c) * depth) + d;
+		if (idx >= cols * rows * depth) {
+			throw std::exception("ERROR! Indexing outside of array");
+		}
+		return idx;
+	}
+
+	void Image::readPng(std::string filepath, unsigned char** pixels, int& w, int& h, int& d, Type& type, const ReadOptions& options)
+	{
+		if (options.channels != 0 && options.channels != 4)
+			throw std::invalid_argument("PNG files can only be read with their own channel count or as RGBA");
+		std::ifstream ifile(filepath, std::ios::in | std::ios::binary);
+		if (!ifile)
+			return;
+		std::vector<unsigned char> data(std::filesystem::file_size(filepath));
+		if (!ifile.read(reinterpret_cast<char*>(data.data()), data.size()))
+			return;
+
+		// The built-in decoder (no libpng needed) writes straight into the final top-down image buffer.
+		int img_width, img_height, img_channels, img_depth;
+		if (png_encoder::inspect(data.data(), data.size(), img_width, img_height, img_channels, img_depth, options.channels))
+			return;
+		if (png_rgba_pixel_limit(img_width, img_height))
+			return;
+		unsigned char* img_data = new unsigned char[(size_t)img_width * img_height * img_channels * (img_depth / 8)];
+		if (png_encoder::decode(img_data, data.data(), data.size(), options.channels))
+		{
+			delete[] img_data;
+			return;
+		}
+
+		w = img_width;
+		h = img_height;
+		d = img_channels;
+		type = img_depth == 16 ? Type::USHORT : Type::UBYTE;
+		delete[] *pixels;
+		*pixels = img_data;
+	}
+
+	static png_encoder::Options pngOptionsOf(const WriteOptions& options)
+	{
+		png_encoder::Options pngOptions;
+		pngOptions.level = options.pngLevel < 0 ? 0 : (unsigned)options.pngLevel;
+		pngOptions.strategy = options.pngStrategy;
+		pngOptions.autoConvert = options.pngAutoConvert;
+		return pngOptions;
+	}
+
+	void Image::writePng(std::string filepath, unsigned char* pixels, int& w, int& h, int& d, Type& type, const WriteOptions& options)
+	{
+		if (type == Type::FLOAT)
+			throw std::exception("Cannot write float data to .png");
+		auto err = png_encoder::saveToFile(filepath, pixels, w, h, d, type == Type::USHORT ? 16 : 8, pngOptionsOf(options));
+		if (err)
+			throw std::exception(("Could not write .png file. Code: " + std::to_string(err)).c_str());
+	}
+
+	struct AnimatedImage::Impl
+	{
+		bool opened = false;
+		bool isGif = false;
+
+		// APNG
+		std::vector<unsigned char> file; // the decoder reads the frames from here
+		png_encoder::AnimationDecoder decoder;
+
+		// GIF: gifdec decodes the color indices of each frame, the frames are composited into canvas here.
+		gif::gd_GIF* gif = nullptr;
+		int gifChannels = 3;
+		int gifFrames = 0;
+		int gifIndex = -1;
+		int gifLoops = 0;
+		std::vector<unsigned char> canvas;
+		std::vector<unsigned char> previous; // the area under a frame disposed with "restore previous"
+		uint16_t fx = 0, fy = 0, fw = 0, fh = 0; // area and disposal of the frame in canvas
+		uint8_t disposal = 0;
+
+		~Impl() { closeGif(); }
+
+		void closeGif()
+		{
+			if (gif)
+				gif::gd_close_gif(gif);
+			gif = nullptr;
+		}
+
+		void restartGif()
+		{
+			gif::gd_rewind(gif);
+			gifIndex = -1;
+			disposal = 0;
+			// Without alpha the canvas starts out as the background color, as in Image::read().
+			const uint8_t* bg = &gif->gct.colors[gif->bgindex * 3];
+			if (gifChannels == 4)
+				std::fill(canvas.begin(), canvas.end(), (unsigned char)0);
+			else
+				for (size_t i = 0; i < canvas.size(); i += 3)
+					memcpy(&canvas[i], bg, 3);
+		}
+
+		// Decodes the next frame on top of the canvas. Returns false at the end of the file.
+		bool nextGifFrame()
+		{
+			int w = gif->width, d = gifChannels;
+			if (gifIndex >= 0 && disposal == 2)
+			{
+				const uint8_t* bg = &gif->gct.colors[gif->bgindex * 3];
+				for (int y = fy; y < fy + fh; ++y)
+				{
+					unsigned char* row = &canvas[((size_t)y * w + fx) * d];
+					for (int x = 0; x < fw; ++x, row += d)
+					{
+						if (d == 4)
+							memset(row, 0, 4);
+						else
+							memcpy(row, bg, 3);
+					}
+				}
+			}
+			else if (gifIndex >= 0 && disposal == 3)
+			{
+				for (int y = 0; y < fh; ++y)
+					memcpy(&canvas[((size_t)(fy + y) * w + fx) * d], &previous[(size_t)y * fw * d], (size_t)fw * d);
+			}
+
+			// A graphic control extension only applies to the frame right after it. The frames are disposed and
+			// composited into canvas here, so gifdec's own canvas is left alone.
+			memset(&gif->gce, 0, sizeof(gif->gce));
+			int ret = gif::gd_decode_frame(gif);
+			if (ret == -1)
+				throw std::exception("Could not load .gif data");
+			if (ret == 0)
+				return false;
+
+			fx = gif->fx;
+			fy = gif->fy;
+			fw = gif->fw;
+			fh = gif->fh;
+			disposal = gif->gce.disposal;
+			if (disposal == 3)
+			{
+				previous.resize((size_t)fw * fh * d);
+				for (int y = 0; y < fh; ++y)
+					memcpy(&previous[(size_t)y * fw * d], &canvas[((size_t)(fy + y) * w + fx) * d], (size_t)fw * d);
+			}
+			const uint8_t* colors = gif->palette->colors;
+			int transparent = gif->gce.transparency ? gif->gce.tindex : -1;
+			for (int y = fy; y < fy + fh; ++y)
+			{
+				const uint8_t* index = &gif->frame[(size_t)y * w + fx];
+				unsigned char* row = &canvas[((size_t)y * w + fx) * d];
+				for (int x = 0; x < fw; ++x, row += d)
+				{
+					if (index[x] == transparent)
+						continue;
+					memcpy(row, &colors[index[x] * 3], 3);
+					if (d == 4)
+						row[3] = 255;
+				}
+			}
+			++gifIndex;
+			return true;
+		}
+
+		void openGif(const std::string& filepath, const ReadOptions& options)
+		{
+			if (options.channels != 0 && options.channels != 3 && options.channels != 4)
+				throw std::invalid_argument("GIF files can only be read as RGB or RGBA");
+			closeGif();
+			gif = gif::gd_open_gif(filepath.c_str());
+			if (!gif)
+				throw std::exception("Could not open gif file");
+			int hasLoop = 0;
+			gifFrames = gif::gd_count_frames(gif, &hasLoop);
+			if (gifFrames == 0)
+				throw std::exception("Could not load .gif data");
+			// The NETSCAPE extension counts repetitions after the first play, without it the animation plays once.
+			gifLoops = !hasLoop ? 1 : gif->loop_count == 0 ? 0 : gif->loop_count + 1;
+			gifChannels = options.channels == 4 ? 4 : 3;
+			canvas.resize((size_t)gif->width * gif->height * gifChannels);
+			restartGif();
+		}
+	};
+
+	AnimatedImage::AnimatedImage() : impl_(new Impl()) {}
+	AnimatedImage::~AnimatedImage() {}
+
+	void AnimatedImage::open(std::string filepath, const ReadOptions& options)
+	{
+		auto ext = std::filesystem::path(filepath).extension().string();
+		for (auto& c : ext)
+			c = std::tolower(c);
+		if (ext != ".png" && ext != ".apng" && ext != ".gif")
+			throw std::invalid_argument("Cannot parse filetype");
+
+		impl_->opened = false;
+		impl_->isGif = ext == ".gif";
+		if (impl_->isGif)
+		{
+			impl_->openGif(filepath, options);
+			impl_->opened = true;
+			return;
+		}
+
+		if (options.channels != 0 && options.channels != 4)
+			throw std::invalid_argument("PNG files can only be read with their own channel count or as RGBA");
+		std::ifstream ifile(filepath, std::ios::in | std::ios::binary);
+		if (!ifile)
+			throw std::exception("Could not open file");
+		impl_->file.resize(std::filesystem::file_size(filepath));
+		if (!ifile.read(reinterpret_cast<char*>(impl_->file.data()), impl_->file.size()))
+			throw std::exception("Could not read file");
+		auto err = impl_->decoder.open(impl_->file.data(), impl_->file.size(), options.channels);
+		if (err)
+			throw std::exception(("Could not read .png file. Code: " + std::to_string(err)).c_str());
+		if (png_rgba_pixel_limit(impl_->decoder.w(), impl_->decoder.h()))
+			throw std::exception("Image too large to read");
+		impl_->opened = true;
+	}
+
+	bool AnimatedImage::next()
+	{
+		if (!impl_->opened || frameIndex() + 1 == frameCount())
+			return false;
+		if (impl_->isGif)
+			return impl_->nextGifFrame();
+		auto err = impl_->decoder.next();
+		if (err)
+			throw std::exception(("Could not read .png frame. Code: " + std::to_string(err)).c_str());
+		return true;
+	}
+
+	void AnimatedImage::seek(int frame)
+	{
+		if (!impl_->opened || frame < 0 || frame >= frameCount())
+			throw std::out_of_range("Frame index out of range");
+		if (impl_->isGif)
+		{
+			// GIF frames can only be decoded in order, so going back restarts from the first frame.
+			if (frame <= impl_->gifIndex)
+				impl_->restartGif();
+			while (impl_->gifIndex + 1 < frame)
+				if (!impl_->nextGifFrame())
+					throw std::exception("Could not load .gif data");
+			return;
+		}
+		auto err = impl_->decoder.seek(frame);
+		if (err)
+			throw std::exception(("Could not read .png frame. Code: " + std::to_string(err)).c_str());
+	}
+
+	int AnimatedImage::channels() const
+	{
+		return !impl_->opened ? 0 : impl_->isGif ? impl_->gifChannels : impl_->decoder.d();
+	}
+	int AnimatedImage::cols() const { return !impl_->opened ? 0 : impl_->isGif ? impl_->gif->width : impl_->decoder.w(); }
+	int AnimatedImage::rows() const { return !impl_->opened ? 0 : impl_->isGif ? impl_->gif->height : impl_->decoder.h(); }
+	Type AnimatedImage::type() const
+	{
+		return impl_->opened && !impl_->isGif && impl_->decoder.bitDepth() == 16 ? Type::USHORT : Type::UBYTE;
+	}
+	int AnimatedImage::frameCount() const
+	{
+		return !impl_->opened ? 0 : impl_->isGif ? impl_->gifFrames : impl_->decoder.numFrames();
+	}
+	int AnimatedImage::frameIndex() const
+	{
+		return !impl_->opened ? -1 : impl_->isGif ? impl_->gifIndex : impl_->decoder.frameIndex();
+	}
+	int AnimatedImage::delayMs() const
+	{
+		return !impl_->opened ? 0 : impl_->isGif ? impl_->gif->gce.delay * 10 : impl_->decoder.delayMs();
+	}
+	int AnimatedImage::loopCount() const
+	{
+		return !impl_->opened ? 0 : impl_->isGif ? impl_->gifLoops : (int)impl_->decoder.numPlays();
+	}
+	const unsigned char* AnimatedImage::data() const
+	{
+		if (!impl_->opened || frameIndex() < 0)
+			return nullptr;
+		return impl_->isGif ? impl_->canvas.data() : impl_->decoder.canvas();
+	}
+
+	void AnimatedImage::write(std::string filepath, const std::vector<AnimationFrame>& frames, int w, int h, int d,
+		Type type, int loopCount, const WriteOptions& options)
+	{
+		auto ext = std::filesystem::path(filepath).extension().string();
+		for (auto& c : ext)
+			c = std::tolower(c);
+		if (ext == ".gif")
+			return writeGifAnimation(filepath, frames, w, h, d, type, loopCount, options);
+		if (ext != ".png" && ext != ".apng")
+			throw std::invalid_argument("Cannot parse filetype");
+		if (type == Type::FLOAT)
+			throw std::exception("Cannot write float data to .png");
+		std::vector<const unsigned char*> pixels;
+		std::vector<int> delays;
+		for (auto& frame : frames)
+		{
+			if (!frame.pixels)
+				throw std::invalid_argument("Animation frame without pixels");
+			pixels.push_back(frame.pixels);
+			delays.push_back(frame.delayMs);
+		}
+		auto err = png_encoder::saveAnimationToFile(filepath, pixels.data(), delays.data(), (int)frames.size(), w, h, d,
+			type == Type::USHORT ? 16 : 8, loopCount < 0 ? 0 : (unsigned)loopCount, pngOptionsOf(options));
+		if (err)
+			throw std::exception(("Could not write .png file. Code: " + std::to_string(err)).c_str());
+	}
+
+#ifndef IMAGECODECS_NO_LIBPNG
+	struct PngStreamDecoder::Impl
+	{
+		png_structp png_ctx = NULL;
+		png_infop info_ctx = NULL;
+		RowCallback onRow;
+		HeaderCallback onHeader;
+		ReadOptions options;
+		Info info;
+		size_t rowBytes = 0;
+		std::vector<unsigned char> image; // interlaced images only: every row as far as the passes so far have filled it
+		std::string errorMessage;
+		std::exception_ptr callbackError;
+		bool finished = false;
+		bool failed = false;
+
+		static void onPngError(png_structp png_ptr, png_const_charp message)
+		{
+			((Impl*)png_get_error_ptr(png_ptr))->errorMessage = message;
+			png_longjmp(png_ptr, 1);
+		}
+
+		static void onPngInfo(png_structp png_ptr, png_infop info_ptr)
+		{
+			Impl* self = (Impl*)png_get_progressive_ptr(png_ptr);
+			preparePngRead(png_ptr, info_ptr, self->options);
+			png_read_update_info(png_ptr, info_ptr);
+			self->info.w = (int)png_get_image_width(png_ptr, info_ptr);
+			self->info.h = (int)png_get_image_height(png_ptr, info_ptr);
+			self->info.d = png_get_channels(png_ptr, info_ptr);
+			self->info.type = png_get_bit_depth(png_ptr, info_ptr) == 16 ? Type::USHORT : Type::UBYTE;
+			self->info.passes = png_get_interlace_type(png_ptr, info_ptr) == PNG_INTERLACE_ADAM7 ? 7 : 1;
+			self->rowBytes = png_get_rowbytes(png_ptr, info_ptr);
+			try
+			{
+				if (self->info.passes > 1)
+					self->image.assign(self->rowBytes * self->info.h, 0);
+				if (self->onHeader)
+					self->onHeader(self->info);
+			}
+			catch (...)
+			{
+				self->callbackError = std::current_exception();
+			}
+			if (self->callbackError)
+				png_error(png_ptr, "PNG header callback failed");
+		}
+
+		static void onPngRow(png_structp png_ptr, png_bytep new_row, png_uint_32 row_num, int pass)
+		{
+			Impl* self = (Impl*)png_get_progressive_ptr(png_ptr);
+			if (new_row == NULL)
+				return; // row not touched by this pass
+			const unsigned char* row = new_row;
+			if (self->info.passes > 1)
+			{
+				// merge the pixels of this pass into what the earlier passes left:
+				png_bytep combined = self->image.data() + row_num * self->rowBytes;
+				png_progressive_combine_row(png_ptr, combined, new_row);
+				row = combined;
+			}
+			try
+			{
+				self->onRow(row, (int)row_num, pass);
+			}
+			catch (...)
+			{
+				self->callbackError = std::current_exception();
+			}
+			if (self->callbackError)
+				png_error(png_ptr, "PNG row callback failed");
+		}
+
+		static void onPngEnd(png_structp png_ptr, png_infop)
+		{
+			Impl* self = (Impl*)png_get_progressive_ptr(png_ptr);
+			self->finished = true;
+			std::vector<unsigned char>().swap(self->image);
+		}
+	};
+
+	PngStreamDecoder::PngStreamDecoder(RowCallback onRow, HeaderCallback onHeader, const ReadOptions& options)
+		: impl_(new Impl())
+	{
+		if (options.channels != 0 && options.channels != 4)
+			throw std::invalid_argument("PNG files can only be read with their own channel count or as RGBA");
+		if (!onRow)
+			throw std::invalid_argument("PngStreamDecoder needs a row callback");
+		impl_->onRow = std::move(onRow);
+		impl_->onHeader = std::move(onHeader);
+		impl_->options = options;
+		impl_->png_ctx = png_create_read_struct(PNG_LIBPNG_VER_STRING, impl_.get(), Impl::onPngError, NULL);
+		if (impl_->png_ctx != NULL)
+			impl_->info_ctx = png_create_info_struct(impl_->png_ctx);
+		if (impl_->info_ctx == NULL)
+		{
+			png_destroy_read_struct(&impl_->png_ctx, NULL, NULL);
+			throw std::bad_alloc();
+		}
+		png_set_progressive_read_fn(impl_->png_ctx, impl_.get(), Impl::onPngInfo, Impl::onPngRow, Impl::onPngEnd);
+	}
+
+	PngStreamDecoder::~PngStreamDecoder()
+	{
+		png_destroy_read_struct(&impl_->png_ctx, &impl_->info_ctx, NULL);
+	}
+
+	void PngStreamDecoder::push(const unsigned char* data, size_t size)
+	{
+		Impl& impl = *impl_;
+		if (impl.failed)
+			throw std::exception("PngStreamDecoder: data pushed after an error");
+		if (impl.finished || size == 0)
+			return;
+		if (setjmp(png_jmpbuf(impl.png_ctx)) != 0)
+		{
+			impl.failed = true;
+			std::vector<unsigned char>().swap(impl.image);
+			if (impl.callbackError)
+				std::rethrow_exception(impl.callbackError);
+			throw std::exception(("Could not read .png data: " + impl.errorMessage).c_str());
+		}
+		png_process_data(impl.png_ctx, impl.info_ctx, const_cast<png_bytep>(data), size);
+	}
+
+	bool PngStreamDecoder::done() const
+	{
+		return impl_->finished;
+	}
+
+	const PngStreamDecoder::Info& PngStreamDecoder::info() const
+	{
+		return impl_->info;
+	}
+#endif
+
+	int getBit(int whichBit)
+	{
+		if (whichBit > 0 && whichBit <= 8)
+			return (1 << (whichBit - 1));
+		else
+			return 0;
+	}
+    void Image::readPbm(std::string filepath, unsigned char** pixels, int& w, int& h, int& d, Type& type)
+    {
+		std::vector<std::uint8_t> data;
+		std::ifstream ifile(filepath, std::ios::in|std::ios::binary);
+		PNM::Info info;
+
+		ifile >> PNM::load(data,info);
+		w = info.width();
+		h = info.height();
+		d = info.channel();
+		bool isPfm = filepath.find(".pfm") != std::string::npos;
+		if (isPfm) // .pfm files contain float data
+		{
+			type = Type::FLOAT;
+		}
+		*pixels = new unsigned char[totalBytes()];
+		if (filepath.find(".pbm") != std::string::npos) // .pbm P4 files are binary black/white, so extract 8 bits of pixel data per byte
+		{
+			if (info.type() == PNM::P4 || info.type() == PNM::P1) // binary pixel data in 1's and 0's
+			{
+				int lastRowBits = w % 8;
+				unsigned int counter = 0;
+				bool endOfRow = false;
+				bool rowJustEnded = false;
+				for (unsigned int i = 0; i < data.size(); ++i)
+				{
+					for (unsigned int j = 0; j < 8; j++)
+					{
+						if (!rowJustEnded && counter > 0 && counter % w == 0) // skip padding bits in byte at end of row.
+						{
+							endOfRow = true;
+						}
+						else
+						{
+							rowJustEnded = false;
+						}
+
+						if (endOfRow && j >= lastRowBits)
+						{
+							endOfRow = false;
+							rowJustEnded = true;
+							break;
+						}
+
+						unsigned char px = (data[i] >> (7 - j)) & 0x01;
+						(*pixels)[counter] = px > 0 ? 0 : 255;
+						counter++;
+					}
+
+					endOfRow = false;
+				}
+			}
+			else
+			{
+				throw std::exception("Error parsing type from .pbm file");
+			}
+		}
+		else
+		{
+			memcpy(*pixels, data.data(), totalBytes());
+		}
+
+		// .pfm rows run from the bottom of the image up, and are kept that way
+		bottomUp_ = isPfm;
+    }
+
+    void Image::writePbm(std::string filepath, unsigned char* pixels, int& w, int& h, int& d, Type& type)
+    {
+        std::ofstream outfile(filepath, std::ofstream::binary);
+        if (outfile.fail())
+        {
+            throw std::exception("Failed to write ");
+        }
+
+		if (filepath.find(".pbm") != std::string::npos)
+		{
+			outfile << "P4" << "\n" << w << " " << h << "\n";
+
+			int lastRowBits = w % 8;
+			size_t counter = 0;
+			bool endOfRow = false;
+			bool rowJustEnded = false;
+			while (counter < totalBytes())
+			{
+				unsigned char byteToWrite = 0;
+				for (unsigned int j = 0; j < 8; j++)
+				{
+					if (!rowJustEnded && counter > 0 && counter % w == 0) // skip padding bits in byte at end of row.
+					{
+						endOfRow = true;
+					}
+					else
+					{
+						rowJustEnded = false;
+					}
+
+					if (endOfRow && j >= lastRowBits)
+					{
+						endOfRow = false;
+						rowJustEnded = true;
+						break;
+					}
+					
+					unsigned char px = (pixels[counter] > 0 ? 0x00 : 0x01);
+					byteToWrite |= (px << (7-j));
+					counter++;
+				}				
+				outfile << byteToWrite;
+				endOfRow = false;
+			}
+		}
+		else if (filepath.find(".pfm") != std::string::npos)
+		{
+			if (type != Type::FLOAT)
+			{
+				throw std::exception("Cannot write non-float data to .pfm");
+			}
+
+			outfile << (d == 3 ? "PF" : "Pf") << (char)0x0A << w << " " << h << (char)0x0A << "-1.0" << (char)0x0A;
+			if (bottomUp_)
+			{
+				outfile.write(reinterpret_cast<char*>(pixels), layerBytes()); // write binary
+			}
+			else
+			{
+				// .pfm rows run from the bottom of the image up
+				for (int y = h - 1; y >= 0; --y)
+					outfile.write(reinterpret_cast<char*>(row(y)), (size_t)w * d * FLOAT_SIZE);
+			}
+		}
+		else if (filepath.find(".pgm") != std::string::npos || filepath.find(".ppm") != std::string::npos || filepath.find(".pnm") != std::string::npos)
+		{
+			bool isPgm = filepath.find(".pgm") != std::string::npos;
+			outfile << (isPgm ? "P5" : "P6") << "\n" << w << " " << h << "\n" << 255 << "\n";
+			outfile.write(reinterpret_cast<char*>(pixels), layerBytes()); // write binary
+		}
+		else
+		{
+			throw std::exception("Could not recognize netpbm format");
+		}
+    }
+
+	template <typename Type>
+	void RGBPaletted(Type* InBuffer, uint8_t* ColorMap, uint8_t* OutBuffer, size_t Size) {
+		const int PixelSize = 3;
+		Type Index;
+		uint8_t Red, Green, Blue;
+		uint8_t* ColorMapPtr;
+		for (size_t i = 0; i < Size; i++) {
+			Index = InBuffer[i];
+			ColorMapPtr = &ColorMap[Index * PixelSize];
+			Blue = *ColorMapPtr++;
+			Green = *ColorMapPtr++;
+			Red = *ColorMapPtr++;
+			*OutBuffer++ = Red;
+			*OutBuffer++ = Green;
+			*OutBuffer++ = Blue;
+		}
+	}
+
+	template <typename Type>
+	void RGBAPaletted(Type* InBuffer, uint8_t* ColorMap, uint8_t* OutBuffer, size_t Size) {
+		const int PixelSize = 4;
+		Type Index;
+		uint8_t Red, Green, Blue, Alpha;
+		uint8_t* ColorMapPtr;
+		for (size_t i = 0; i < Size; i++) {
+			Index = InBuffer[i];
+			ColorMapPtr = &ColorMap[Index * PixelSize];
+			Blue = *ColorMapPtr++;
+			Green = *ColorMapPtr++;
+			Red = *ColorMapPtr++;
+			Alpha = *ColorMapPtr++;
+			*OutBuffer++ = Red;
+			*OutBuffer++ = Green;
+			*OutBuffer++ = Blue;
+			*OutBuffer++ = Alpha;
+		}
+	}
+
+	void MonochromeCompressed(uint8_t* InBuffer, uint8_t* OutBuffer, size_t Size) {
+		uint8_t Header;
+		uint8_t Red;
+		size_t i, j, PixelCount;
+		for (i = 0; i < Size; ) {
+			Header = *InBuffer++;
+			PixelCount = (Header & 0x7F) + 1;
+			if (Header & 0x80) {
+				Red = *InBuffer++;
+				for (j = 0; j < PixelCount; j++)
+					*OutBuffer++ = Red;
+				i += PixelCount;
+			}
+			else {
+				for (j = 0; j < PixelCount; j++) {
+					Red = *InBuffer++;
+					*OutBuffer++ = Red;
+				}
+				i += PixelCount;
+			}
+		}
+	}
+
+	void RGBCompressed(uint8_t* InBuffer, uint8_t* OutBuffer, size_t Size) {
+		uint8_t Header;
+		uint8_t Red, Green, Blue;
+		size_t i, j, PixelCount;
+		for (i = 0; i < Size; ) {
+			Header = *InBuffer++;
+			PixelCount = (Header & 0x7F) + 1;
+
+			if (Header & 0x80) {
+				Blue = *InBuffer++;
+				Green = *InBuffer++;
+				Red = *InBuffer++;
+				for (j = 0; j < PixelCount; j++) {
+					*OutBuffer++ = Red;
+					*OutBuffer++ = Green;
+					*OutBuffer++ = Blue;
+				}
+				i += PixelCount;
+			}
+			else {
+				for (j = 0; j < PixelCount; j++) {
+					Blue = *InBuffer++;
+					Green = *InBuffer++;
+					Red = *InBuffer++;
+					*OutBuffer++ = Red;
+					*OutBuffer++ = Green;
+					*OutBuffer++ = Blue;
+				}
+				i += PixelCount;
+			}
+		}
+	}
+
+	void RGBACompressed(uint8_t* InBuffer, uint8_t* OutBuffer, size_t Size) {
+		uint8_t Header;
+		uint8_t Red, Green, Blue, Alpha;
+		size_t i, j, PixelCount;
+
+		for (i = 0; i < Size; ) {
+			Header = *InBuffer++;
+			PixelCount = (Header & 0x7F) + 1;
+
+			if (Header & 0x80) {
+				Blue = *InBuffer++;
+				Green = *InBuffer++;
+				Red = *InBuffer++;
+				Alpha = *InBuffer++;
+
+				for (j = 0; j < PixelCount; j++) {
+					*OutBuffer++ = Red;
+					*OutBuffer++ = Green;
+					*OutBuffer++ = Blue;
+					*OutBuffer++ = Alpha;
+				}
+				i += PixelCount;
+			}
+			else {
+				for (j = 0; j < PixelCount; j++) {
+					Blue = *InBuffer++;
+					Green = *InBuffer++;
+					Red = *InBuffer++;
+					Alpha = *InBuffer++;
+
+					*OutBuffer++ = Red;
+					*OutBuffer++ = Green;
+					*OutBuffer++ = Blue;
+					*OutBuffer++ = Alpha;
+				}
+				i += PixelCount;
+			}
+		}
+	}
+
+	// Modified from: https://github.com/ColumbusUtrigas/TGA
+	void Image::readTga(std::string filepath, unsigned char** pixels, int& w, int& h, int& d, Type& type)
+	{
+		std::ifstream File(filepath, std::ios::binary);
+		if (!File.is_open()) return;
+		struct Header {
+			uint8_t IDLength;
+			uint8_t ColorMapType;
+			uint8_t ImageType;
+			uint16_t ColorMapOrigin;
+			uint16_t ColorMapLength;
+			uint8_t  ColorMapEntrySize;
+			uint16_t XOrigin;
+			uint16_t YOrigin;
+			uint16_t Width;
+			uint16_t Height;
+			uint8_t  Bits;
+			uint8_t  ImageDescriptor;
+		} Head;
+		size_t FileSize = std::filesystem::file_size(filepath);
+		File.read((char*)&Head.IDLength, sizeof(Head.IDLength));
+		File.read((char*)&Head.ColorMapType, sizeof(Head.ColorMapType));
+		File.read((char*)&Head.ImageType, sizeof(Head.ImageType));
+		File.read((char*)&Head.ColorMapOrigin, sizeof(Head.ColorMapOrigin));
+		File.read((char*)&Head.ColorMapLength, sizeof(Head.ColorMapLength));
+		File.read((char*)&Head.ColorMapEntrySize, sizeof(Head.ColorMapEntrySize));
+		File.read((char*)&Head.XOrigin, sizeof(Head.XOrigin));
+		File.read((char*)&Head.YOrigin, sizeof(Head.YOrigin));
+		File.read((char*)&Head.Width, sizeof(Head.Width));
+		File.read((char*)&Head.Height, sizeof(Head.Height));
+		File.read((char*)&Head.Bits, sizeof(Head.Bits));
+		File.read((char*)&Head.ImageDescriptor, sizeof(Head.ImageDescriptor));
+		uint8_t* Descriptor = new uint8_t[Head.IDLength];
+		File.read((char*)Descriptor, Head.IDLength);
+		size_t ColorMapElementSize = Head.ColorMapEntrySize / 8;
+		size_t ColorMapSize = Head.ColorMapLength * ColorMapElementSize;
+		uint8_t* ColorMap = new uint8_t[ColorMapSize];
+		if (Head.ColorMapType == 1)
+			File.read((char*)ColorMap, ColorMapSize);
+		size_t PixelSize = Head.ColorMapLength == 0 ? (Head.Bits / 8) : ColorMapElementSize;
+		// the header takes 18 bytes in the file, fewer than the padded Header struct
+		size_t DataSize = FileSize - 18 - Head.IDLength - (Head.ColorMapType == 1 ? ColorMapSize : 0);
+		size_t ImageSize = Head.Width * Head.Height * PixelSize;
+		uint8_t* Buffer = new uint8_t[DataSize];
+		File.read((char*)Buffer, DataSize);
+		*pixels = new unsigned char[ImageSize];
+		memset(*pixels, 0, ImageSize);
+		switch (Head.ImageType) {
+			case 0: break; // No Image
+			case 1: {// Uncompressed paletted		
+				if (Head.Bits == 8) {
+					switch (PixelSize) {
+					case 3: RGBPaletted((uint8_t*)Buffer, ColorMap, *pixels, Head.Width * Head.Height); break;
+					case 4: RGBAPaletted((uint8_t*)Buffer, ColorMap, *pixels, Head.Width * Head.Height); break;
+					}
+				}
+				else if (Head.Bits == 16) {
+					switch (PixelSize) {
+					case 3: RGBPaletted((uint16_t*)Buffer, ColorMap, *pixels, Head.Width * Head.Height); break;
+					case 4: RGBAPaletted((uint16_t*)Buffer, ColorMap, *pixels, Head.Width * Head.Height); break;
+					}
+				}
+				break;
+			}
+			case 2: {// Uncompressed TrueColor		
+				if (Head.Bits = 24 || Head.Bits == 32) {
+					std::copy(&Buffer[0], &Buffer[ImageSize], *pixels);
+
+					// Swap R<->B channels.
+					for (size_t i = 0; i < ImageSize; i += PixelSize)
+					{
+						std::swap((*pixels)[i], (*pixels)[i + 2]);						
+					}
+				}
+				break;
+			}
+			case 3: {// Uncompressed Monochrome		
+				if (Head.Bits == 8)
+					std::copy(&Buffer[0], &Buffer[ImageSize], &(*pixels)[0]);
+				break;
+			}
+			case 9: break; // Compressed paletted TODO
+			case 10: {// Compressed TrueColor		
+				switch (Head.Bits)
+				{
+				case 24: RGBCompressed(Buffer, *pixels, Head.Width * Head.Height); break;
+				case 32: RGBACompressed(Buffer, *pixels, Head.Width * Head.Height); break;
+				}
+				break;
+			}
+			case 11: {// Compressed Monocrhome		
+				if (Head.Bits == 8)
+					MonochromeCompressed(Buffer, *pixels, Head.Width * Head.Height);
+				break;
+			}
+		}
+
+		if (Head.ImageType != 0) {
+			d = PixelSize;
+			w = Head.Width;
+			h = Head.Height;
+			// Rows are kept in the order of the file, which is bottom-up unless bit 5 of the descriptor is set
+			bottomUp_ = !(Head.ImageDescriptor & 0x20);
+		}
+		delete[] ColorMap;
+		delete[] Descriptor;
+	}
+
+	// NOTE: only writes uncompressed .tga for now.
+    void Image::writeTga(std::string filepath, unsigned char* pixels, int& w, int& h, int& d, Type& type)
+    {
+        FILE* fp = NULL;
+        fp = fopen(filepath.c_str(), "wb");
+        if (fp == NULL)
+            return;
+
+        unsigned char header[18] =
+        {
+            0,0,2,0,0,0,0,0,0,0,0,0,
+            (unsigned char)(w % 256),
+            (unsigned char)(w / 256),
+            (unsigned char)(h % 256),
+            (unsigned char)(h / 256),
+            (unsigned char)(d * 8),
+            (unsigned char)(bottomUp_ ? 0x00 : 0x20) // rows stay in the order the image keeps them
+        };
+        fwrite(&header, 18, 1, fp);
+
+        for (int i = 0; i < w * h; i++)
+        {
+            for (int b = 0; b < d; b++)
+            {
+                fputc(pixels[(i * d) + (b % d)], fp);
+            }
+        }
+        fclose(fp);
+    }
+
+	void Image::readTiff(std::string filepath, unsigned char** pixels, int& w, int& h, int& d, Type& type)
+    {
+		TIFF* tif = TIFFOpen(filepath.c_str(), "r");
+		uint32_t* buf;
+		tsize_t scanlineSz;
+		TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &w);
+		TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &h);
+		TIFFGetField(tif, TIFFTAG_SAMPLESPERPIXEL, &d);
+		int bitDepth = 0;
+		TIFFGetField(tif, TIFFTAG_BITSPERSAMPLE, &bitDepth);
+		if (bitDepth > 8)
+		{
+			switch (bitDepth)
+			{
+			case 16:
+				type = Type::USHORT;
+			case 32:
+				type = Type::FLOAT;
+			}
+		}
+		*pixels = new unsigned char[totalBytes()];
+
+		scanlineSz = TIFFScanlineSize(tif);
+		buf = new uint32_t[w*h];//(tdata_t*)_TIFFmalloc(scanlineSz);
+		if (!TIFFReadRGBAImageOriented(tif, (uint32_t)w, (uint32_t)h, (uint32_t*)buf, ORIENTATION_TOPLEFT, 1))
+		{
+			std::cerr << "Error reading .tiff file" << std::endl;
+			throw std::exception("Error reading .tff file");
+		}
+		unsigned int counter = 0;
+
+		for (unsigned int i = 0; i < w * h; ++i)
+		{
+			uint32_t currPix = (uint32_t)buf[i];
+			for (unsigned int j = 0; j < d; ++j)
+			{
+				unsigned char currByte = unsigned char((currPix >> (j * 8)) & 0xff); // R in the low byte, A in the high one
+				(*pixels)[counter] = currByte;
+				counter++;
+			}
+		}
+
+		// Cleanup.
+		delete[] buf;
+		TIFFClose(tif);
+	}
+	void Image::writeTiff(std::string filepath, unsigned char* pixels, int& w, int& h, int& d, Type& type)
+    {
+		TIFF* tif = TIFFOpen(filepath.c_str(), "w");
+		TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, w);
+		TIFFSetField(tif, TIFFTAG_IMAGELENGTH, h);
+		TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, d);
+
+		switch (type)
+		{
+		case Type::FLOAT:
+			TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, 32);
+			break;
+		case Type::USHORT:
+			TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, 16);
+			break;
+		default:
+			TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, 8);
+			break;
+		}
+
+		TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, h);
+		TIFFSetField(tif, TIFFTAG_COMPRESSION, COMPRESSION_ADOBE_DEFLATE);
+		TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_RGB);
+		TIFFSetField(tif, TIFFTAG_FILLORDER, FILLORDER_MSB2LSB);
+		TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+
+		TIFFWriteEncodedStrip(tif, 0,const_cast<void*>(reinterpret_cast<const void*> (pixels)),tsize_t(layerBytes()));
+		TIFFClose(tif);
+	}
+
+	void Image::readWebp(std::string filepath, unsigned char** pixels, int& w, int& h, int& d, Type& type)
+    {		
+		// Validate header.
+		std::ifstream ifile(filepath, std::ios::in | std::ios::binary);
+		if (!ifile.is_open())
+		{
+			throw std::exception(("Could not open .webp file: " + filepath).c_str());
+		}
+		std::vector<uint8_t> data;
+		while (ifile.good())
+		{
+			data.push_back((uint8_t)ifile.get());
+		}
+		auto sz = std::filesystem::file_size(filepath);
+
+		// Read contents.
+		if (!WebPGetInfo(data.data(), sz, &w, &h))
+		{
+			throw std::exception("Could not parse .webp header");
+		}
+		*pixels = WebPDecodeRGBA(data.data(), sz, &w, &h);
+		d = 4; // in this setup, webp is RGBA by default
+    }
+
+	typedef struct MetadataPayload {
+		uint8_t* bytes;
+		size_t size;
+	} MetadataPayload;
+
+	typedef struct Metadata {
+		MetadataPayload exif;
+		MetadataPayload iccp;
+		MetadataPayload xmp;
+	} Metadata;
+
+	// Metadata writing.
+
+	enum {
+		METADATA_EXIF = (1 << 0),
+		METADATA_ICC = (1 << 1),
+		METADATA_XMP = (1 << 2),
+		METADATA_ALL = METADATA_EXIF | METADATA_ICC | METADATA_XMP
+	};
+
+	static const int kChunkHeaderSize = 8;
+	static const int kTagSize = 4;
+
+	// Sets 'flag' in 'vp8x_flags' and updates 'metadata_size' with the size of the
+	// chunk if there is metadata and 'keep' is true.
+	static int UpdateFlagsAndSize(const MetadataPayload* const payload,
+		int keep, int flag,
+		uint32_t* vp8x_flags, uint64_t* metadata_size) {
+		if (keep && payload->bytes != NULL && payload->size > 0) {
+			*vp8x_flags |= flag;
+			*metadata_size += kChunkHeaderSize + payload->size + (payload->size & 1);
+			return 1;
+		}
+		return 0;
+	}
+
+	// Outputs, in little endian, 'num' bytes from 'val' to 'out'.
+	static int WriteLE(FILE* const out, uint32_t val, int num) {
+		uint8_t buf[4];
+		int i;
+		for (i = 0; i < num; ++i) {
+			buf[i] = (uint8_t)(val & 0xff);
+			val >>= 8;
+		}
+		return (fwrite(buf, num, 1, out) == 1);
+	}
+
+	static int WriteLE24(FILE* const out, uint32_t val) {
+		return WriteLE(out, val, 3);
+	}
+
+	static int WriteLE32(FILE* const out, uint32_t val) {
+		return WriteLE(out, val, 4);
+	}
+
+	static int WriteMetadataChunk(FILE* const out, const char fourcc[4],
+		const MetadataPayload* const payload) {
+		const uint8_t zero = 0;
+		const size_t need_padding = payload->size & 1;
+		int ok = (fwrite(fourcc, kTagSize, 1, out) == 1);
+		ok = ok && WriteLE32(out, (uint32_t)payload->size);
+		ok = ok && (fwrite(payload->bytes, payload->size, 1, out) == 1);
+		return ok && (fwrite(&zero, need_padding, need_padding, out) == need_padding);
+	}
+
+	static int WriteWebPWithMetadata(FILE* const out,
+		const WebPPicture* const picture,
+		const WebPMemoryWriter* const memory_writer,
+		const Metadata* const metadata,
+		int keep_metadata,
+		int* const metadata_written) {
+		const char kVP8XHeader[] = "VP8X\x0a\x00\x00\x00";
+		const int kAlphaFlag = 0x10;
+		const int kEXIFFlag = 0x08;
+		const int kICCPFlag = 0x20;
+		const int kXMPFlag = 0x04;
+		const size_t kRiffHeaderSize = 12;
+		const size_t kMaxChunkPayload = ~0 - kChunkHeaderSize - 1;
+		const size_t kMinSize = kRiffHeaderSize + kChunkHeaderSize;
+		uint32_t flags = 0;
+		uint64_t metadata_size = 0;
+		const int write_exif = UpdateFlagsAndSize(&metadata->exif,
+			!!(keep_metadata & METADATA_EXIF),
+			kEXIFFlag, &flags, &metadata_size);
+		const int write_iccp = UpdateFlagsAndSize(&metadata->iccp,
+			!!(keep_metadata & METADATA_ICC),
+			kICCPFlag, &flags, &metadata_size);
+		const int write_xmp = UpdateFlagsAndSize(&metadata->xmp,
+			!!(keep_metadata & METADATA_XMP),
+			kXMPFlag, &flags, &metadata_size);
+		uint8_t* webp = memory_writer->mem;
+		size_t webp_size = memory_writer->size;
+
+		*metadata_written = 0;
+
+		if (webp_size < kMinSize) return 0;
+		if (webp_size - kChunkHeaderSize + metadata_size > kMaxChunkPayload) {
+			fprintf(stderr, "Error! Addition of metadata would exceed "
+				"container size limit.\n");
+			return 0;
+		}
+
+		if (metadata_size > 0) {
+			const int kVP8XChunkSize = 18;
+			const int has_vp8x = !memcmp(webp + kRiffHeaderSize, "VP8X", kTagSize);
+			const uint32_t riff_size = (uint32_t)(webp_size - kChunkHeaderSize +
+				(has_vp8x ? 0 : kVP8XChunkSize) +
+				metadata_size);
+			// RIFF
+			int ok = (fwrite(webp, kTagSize, 1, out) == 1);
+			// RIFF size (file header size is not recorded)
+			ok = ok && WriteLE32(out, riff_size);
+			webp += kChunkHeaderSize;
+			webp_size -= kChunkHeaderSize;
+			// WEBP
+			ok = ok && (fwrite(webp, kTagSize, 1, out) == 1);
+			webp += kTagSize;
+			webp_size -= kTagSize;
+			if (has_vp8x) {  // update the existing VP8X flags
+				webp[kChunkHeaderSize] |= (uint8_t)(flags & 0xff);
+				ok = ok && (fwrite(webp, kVP8XChunkSize, 1, out) == 1);
+				webp += kVP8XChunkSize;
+				webp_size -= kVP8XChunkSize;
+			}
+			else {
+				const int is_lossless = !memcmp(webp, "VP8L", kTagSize);
+				if (is_lossless) {
+					// Presence of alpha is stored in the 37th bit (29th after the
+					// signature) of VP8L data.
+					if (webp[kChunkHeaderSize + 4] & (1 << 4)) flags |= kAlphaFlag;
+				}
+				ok = ok && (fwrite(kVP8XHeader, kChunkHeaderSize, 1, out) == 1);
+				ok = ok && WriteLE32(out, flags);
+				ok = ok && WriteLE24(out, picture->width - 1);
+				ok = ok && WriteLE24(out, picture->height - 1);
+			}
+			if (write_iccp) {
+				ok = ok && WriteMetadataChunk(out, "ICCP", &metadata->iccp);
+				*metadata_written |= METADATA_ICC;
+			}
+			// Image
+			ok = ok && (fwrite(webp, webp_size, 1, out) == 1);
+			if (write_exif) {
+				ok = ok && WriteMetadataChunk(out, "EXIF", &metadata->exif);
+				*metadata_written |= METADATA_EXIF;
+			}
+			if (write_xmp) {
+				ok = ok && WriteMetadataChunk(out, "XMP ", &metadata->xmp);
+				*metadata_written |= METADATA_XMP;
+			}
+			return ok;
+		}
+
+		// No metadata, just write the original image file.
+		return (fwrite(webp, webp_size, 1, out) == 1);
+	}
+
+
+	void Image::writeWebp(std::string filepath, unsigned char* pixels, int& w, int& h, int& d, Type& type)
+    {	
+		WebPPicture pic;
+		WebPPictureInit(&pic);
+		pic.width = w;
+		pic.height = h;		
+		pic.argb_stride = w * d * byteSize();
+		WebPPictureImportRGBA(&pic,pixels,w*d*byteSize());
+		if (pic.error_code)
+		{
+			throw std::exception(("WebPEncode failed. Error code: " + std::to_string((int)pic.error_code)).c_str());
+		}
+
+		// Extract a configuration from the packed bits.
+		WebPConfig config;
+		WebPConfigInit(&config);
+		WebPConfigLosslessPreset(&config, 6);
+		if (!WebPValidateConfig(&config)) {
+			throw std::exception("Error! Invalid configuration.");
+		}
+
+
+		// Encode.
+		WebPMemoryWriter memory_writer;
+		WebPMemoryWriterInit(&memory_writer);		
+		pic.writer = WebPMemoryWrite;
+		pic.custom_ptr = &memory_writer;		
+		if (!WebPEncode(&config, &pic)) {
+			const WebPEncodingError error_code = pic.error_code;
+			WebPMemoryWriterClear(&memory_writer);
+			WebPPictureFree(&pic);
+			if (error_code == VP8_ENC_ERROR_OUT_OF_MEMORY ||
+				error_code == VP8_ENC_ERROR_BAD_WRITE) {
+				return;
+			}
+			throw std::exception(("WebPEncode failed. Error code: " + std::to_string((int)error_code)).c_str());
+		}
+
+		FILE* out = fopen(filepath.c_str(), "wb");
+		Metadata metadata;
+		int metadata_written;
+
+		if (!WriteWebPWithMetadata(out, &pic, &memory_writer, &metadata,
+				false, &metadata_written)) {
+			throw std::exception("Error writing WebP file!\n");		
+		}
+
+		WebPMemoryWriterClear(&memory_writer);
+		WebPPictureFree(&pic);
+		fclose(out);
+    }
 }
\ No newline at end of file
@@ -1,104 +1,295 @@
-#pragma once
-#include <cmath>
-#include <exception>
-#include <string>
-#include <vector>
-
-namespace ImageCodecs
-{
-	enum class Type
-	{
-		UBYTE,
-		USHORT,
-		FLOAT
-	};
-
-	class Image
-	{
-		const int USHORT_SIZE = 2; // this lib requires the size of all 'ushort' types == 2 bytes, else many decoders will not work.
-		const int FLOAT_SIZE = 4; // this lib requires the size of all 'float' types == 4 bytes, else many decoders will not work.
-		int h_ = 0;
-		int w_ = 0;
-		int d_ = 0;
-		unsigned char* pixels_ = nullptr;
-		Type type_ = Type::UBYTE;
-		
-		inline int byteSize(Type type)
-		{
-			if (type_ == Type::FLOAT)
-				return FLOAT_SIZE;
-			else if (type_ == Type::USHORT)
-				return USHORT_SIZE;
-			else
-				return 1;
-		}
-		void flip(unsigned char* pixels, const int w, const int h, const int d, const Type& type);
-		void swapBR(unsigned char* pixels, const int w, const int h, const int d, const Type& type);
-		void transpose(unsigned char* pixels, const int w, const int h, const int d, const Type& type);
-
-		// codecs per filetype:
-		void readBmp(std::string filename, unsigned char** pixels, int& w, int& h, int& d, Type& type);
-		void writeBmp(std::string filename, unsigned char* pixels, int& w, int& h, int& d, Type& type);
-
-		void readDds(std::string filename, unsigned char** pixels, int& w, int& h, int& d, Type& type);
-		void writeDds(std::string filename, unsigned char* pixels, int& w, int& h, int& d, Type& type);
-
-		void readExr(std::string filename, unsigned char** pixels, int& w, int& h, int& d, Type& type);
-		void writeExr(std::string filename, unsigned char* pixels, int& w, int& h, int& d, Type& type);
-
-		void readGif(std::string filename, unsigned char** pixels, int& w, int& h, int& d, Type& type);
-		void writeGif(std::string filename, unsigned char* pixels, int& w, int& h, int& d, Type& type);
-
-		void readHdr(std::string filename, unsigned char** pixels, int& w, int& h, int& d, Type& type);
-		void writeHdr(std::string filename, unsigned char* pixels, int& w, int& h, int& d, Type& type);
-
-		void readJpg(std::string filename, unsigned char** pixels, int& w, int& h, int& d, Type& type);
-		void writeJpg(std::string filename, unsigned char* pixels, int& w, int& h, int& d, Type& type);
-
-		void readPng(std::string filename, unsigned char** pixels, int& w, int& h, int& d, Type& type);
-		void writePng(std::string filename, unsigned char* pixels, int& w, int& h, int& d, Type& type);
-
-		// NOTE: works for all netpnm types: pbm,pfm,pgm,ppm,pnm
-		void readPbm(std::string filename, unsigned char** pixels, int& w, int& h, int& d, Type& type);
-		void writePbm(std::string filename, unsigned char* pixels, int& w, int& h, int& d, Type& type);
-
-		void readTga(std::string filename, unsigned char** pixels, int& w, int& h, int& d, Type& type);
-		void writeTga(std::string filename, unsigned char* pixels, int& w, int& h, int& d, Type& type);
-
-		void readTiff(std::string filename, unsigned char** pixels, int& w, int& h, int& d, Type& type);
-		void writeTiff(std::string filename, unsigned char* pixels, int& w, int& h, int& d, Type& type);
-
-		void readWebp(std::string filename, unsigned char** pixels, int& w, int& h, int& d, Type& type);
-		void writeWebp(std::string filename, unsigned char* pixels, int& w, int& h, int& d, Type& type);
-
-	public:
-		inline int byteSize() { return byteSize(type_); }
-		inline int channels() { return d_; }
-		inline int cols() { return w_; }
-		inline unsigned char** data() { return &pixels_; }
-		inline bool empty() { return h_ == 0 || w_ == 0 || d_ == 0 || pixels_ == nullptr; }
-		inline void flip() { flip(pixels_, w_, h_, d_, type_); }
-		// row-major index access for contiguous array of pixel data.
-		template <typename T>
-		inline T idx(int i, int j, int k)
-		{
-			T ret;
-			memcpy(&T, pixels_ + (i * w_ * d_ * sizeof(T) + j * d_ * sizeof(T) + k * sizeof(T)), sizeof(T));
-			return ret;
-		}
-		inline void load(unsigned char* pixels, int w, int h, int channels)
-		{
-			d_ = channels;
-			w_ = w;
-			h_ = h;
-			pixels_ = pixels;
-		}
-		void read(std::string filepath);
-		inline int rows() { return h_; }
-		inline void swapBR(){swapBR(pixels_, w_, h_, d_, type_);}
-		inline int totalBytes() { return w_ * h_ * d_ * byteSize(); }
-		inline Type type() { return type_; }
-		void write(std::string filepath);
-		~Image(){delete[] pixels_;}
-	};
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "png_encoder.h"
+
+namespace ImageCodecs
+{
+	enum class Type
+	{
+		UBYTE,
+		USHORT,
+		FLOAT
+	};
+
+	// How the PNG encoder searches for repeated data, on top of what the compression level selects.
+	using PngStrategy = png_encoder::Strategy;
+
+	// How GIF writing spreads the difference between the image's colors and the palette's.
+	enum class GifDither
+	{
+		DEFAULT,         // FLOYD_STEINBERG for still images, ORDERED for animations
+		NONE,            // nearest palette color: flat areas stay flat, gradients show bands
+		FLOYD_STEINBERG, // error diffusion: smoothest gradients
+		ORDERED          // 8x8 Bayer pattern: stays put between animation frames and compresses better than diffusion
+	};
+
+	// Block compression of the DDS files Image::write() makes. The image has to be 8-bit; gray is stored as RGB.
+	enum class DdsCompression
+	{
+		NONE, // the pixels as they are: 1, 3 or 4 channels
+		BC1,  // DXT1: 4 bits per pixel, RGB with alpha either on or off
+		BC3,  // DXT5: 8 bits per pixel, RGB with smooth alpha
+		BC7   // 8 bits per pixel, closer to the image than BC1 and BC3 but slower to compress; needs a DX10 reader
+	};
+
+	// Mipmaps that Image::write() adds to DDS files, each level filtered from the one above it in linear light.
+	enum class MipFilter
+	{
+		NONE,  // only the image itself
+		BOX,   // average of the 2x2 pixels under each pixel: fast
+		KAISER // Kaiser windowed sinc: sharper, with less aliasing, at about 3 times the cost of BOX
+	};
+
+	// Encoder settings for Image::write(). Each codec only looks at the fields meant for it.
+	struct WriteOptions
+	{
+		int pngLevel = 6; // zlib-like level from 0 (stored, fastest) to 9 (smallest, slowest).
+		PngStrategy pngStrategy = PngStrategy::DEFAULT;
+		bool pngAutoConvert = true; // Writes palette, gray or color key PNGs when that loses nothing; false keeps the image's channels.
+		int gifColors = 256; // palette size from 2 (3 for animations) to 256; images with no more colors than that are stored exactly.
+		GifDither gifDither = GifDither::DEFAULT;
+		DdsCompression ddsCompression = DdsCompression::NONE;
+		int ddsQuality = 1; // block compression effort from 0 (fastest) to 2 (closest to the image); blocks are compressed on the thread pool.
+		MipFilter ddsMipmaps = MipFilter::NONE; // full mipmap chain down to 1x1, compressed as ddsCompression says.
+	};
+
+	// Decoder settings for Image::read(). Each codec only looks at the fields meant for it.
+	struct ReadOptions
+	{
+		int channels = 0; // 0 keeps the file's own channel count, 4 expands every image to RGBA (PNG, and GIF in AnimatedImage).
+		int ddsMipLevel = 0; // mipmap level of a DDS file to read, 0 for the full size; larger levels are skipped, not read.
+	};
+
+	// Threads the codecs share for the work they split up, such as EXR chunks, PNG deflate, DDS blocks and mipmaps,
+	// and GIF frames, the calling thread included. The default is one per core; 0 goes back to that. Set it before
+	// reading or writing images, not while another thread does.
+	void setThreadCount(unsigned numThreads);
+	unsigned threadCount();
+
+	// How the layers of an Image fit together. Only DDS files hold more than one; the other formats read and write
+	// the first layer.
+	enum class Layout
+	{
+		FLAT,    // a single 2D image
+		CUBEMAP, // 6 faces, +X, -X, +Y, -Y, +Z, -Z; arrays of cubemaps are read as 6 faces after another
+		VOLUME,  // the slices of a 3D texture, front to back
+		ARRAY    // 2D images of the same size
+	};
+
+	class Image
+	{
+		const int USHORT_SIZE = 2; // this lib requires the size of all 'ushort' types == 2 bytes, else many decoders will not work.
+		const int FLOAT_SIZE = 4; // this lib requires the size of all 'float' types == 4 bytes, else many decoders will not work.
+		int h_ = 0;
+		int w_ = 0;
+		int d_ = 0;
+		int layers_ = 1;
+		Layout layout_ = Layout::FLAT;
+		bool bottomUp_ = false;
+		unsigned char* pixels_ = nullptr;
+		Type type_ = Type::UBYTE;
+		
+		inline int byteSize(Type type)
+		{
+			if (type_ == Type::FLOAT)
+				return FLOAT_SIZE;
+			else if (type_ == Type::USHORT)
+				return USHORT_SIZE;
+			else
+				return 1;
+		}
+		void flip(unsigned char* pixels, const int w, const int h, const int d, const Type& type);
+		void swapBR(unsigned char* pixels, const int w, const int h, const int d, const Type& type);
+		void transpose(unsigned char* pixels, const int w, const int h, const int d, const Type& type);
+
+		// codecs per filetype:
+		void readBmp(std::string filename, unsigned char** pixels, int& w, int& h, int& d, Type& type);
+		void writeBmp(std::string filename, unsigned char* pixels, int& w, int& h, int& d, Type& type);
+
+		void readDds(std::string filename, unsigned char** pixels, int& w, int& h, int& d, Type& type, const ReadOptions& options);
+		void writeDds(std::string filename, unsigned char* pixels, int& w, int& h, int& d, Type& type, const WriteOptions& options);
+
+		void readExr(std::string filename, unsigned char** pixels, int& w, int& h, int& d, Type& type);
+		void writeExr(std::string filename, unsigned char* pixels, int& w, int& h, int& d, Type& type);
+
+		void readGif(std::string filename, unsigned char** pixels, int& w, int& h, int& d, Type& type);
+		void writeGif(std::string filename, unsigned char* pixels, int& w, int& h, int& d, Type& type, const WriteOptions& options);
+
+		void readHdr(std::string filename, unsigned char** pixels, int& w, int& h, int& d, Type& type);
+		void writeHdr(std::string filename, unsigned char* pixels, int& w, int& h, int& d, Type& type);
+
+		void readJpg(std::string filename, unsigned char** pixels, int& w, int& h, int& d, Type& type);
+		void writeJpg(std::string filename, unsigned char* pixels, int& w, int& h, int& d, Type& type);
+
+		void readPng(std::string filename, unsigned char** pixels, int& w, int& h, int& d, Type& type, const ReadOptions& options);
+		void writePng(std::string filename, unsigned char* pixels, int& w, int& h, int& d, Type& type, const WriteOptions& options);
+
+		// NOTE: works for all netpnm types: pbm,pfm,pgm,ppm,pnm
+		void readPbm(std::string filename, unsigned char** pixels, int& w, int& h, int& d, Type& type);
+		void writePbm(std::string filename, unsigned char* pixels, int& w, int& h, int& d, Type& type);
+
+		void readTga(std::string filename, unsigned char** pixels, int& w, int& h, int& d, Type& type);
+		void writeTga(std::string filename, unsigned char* pixels, int& w, int& h, int& d, Type& type);
+
+		void readTiff(std::string filename, unsigned char** pixels, int& w, int& h, int& d, Type& type);
+		void writeTiff(std::string filename, unsigned char* pixels, int& w, int& h, int& d, Type& type);
+
+		void readWebp(std::string filename, unsigned char** pixels, int& w, int& h, int& d, Type& type);
+		void writeWebp(std::string filename, unsigned char* pixels, int& w, int& h, int& d, Type& type);
+
+	public:
+		inline int byteSize() { return byteSize(type_); }
+		inline int channels() { return d_; }
+		inline int cols() { return w_; }
+		inline unsigned char** data() { return &pixels_; }
+		inline bool empty() { return h_ == 0 || w_ == 0 || d_ == 0 || pixels_ == nullptr; }
+		// Mirrors the rows of data() top to bottom.
+		inline void flip() { for (int i = 0; i < layers_; ++i) flip(layer(i), w_, h_, d_, type_); }
+		// True when the rows of data() run from the bottom of the image up, as BMP, PFM and TGA files keep them,
+		// which read() leaves them in rather than flipping them. write() stores them as they are where the format
+		// allows it; row() and idx() count rows from the top either way.
+		inline bool bottomUp() { return bottomUp_; }
+		// Puts the rows of data() in the order asked for; they are only moved when they are in the other order.
+		inline void setBottomUp(bool bottomUp)
+		{
+			if (bottomUp != bottomUp_)
+				flip();
+			bottomUp_ = bottomUp;
+		}
+		// Row y of layer i, counted from the top of the image.
+		inline unsigned char* row(int y, int i = 0) { return layer(i) + (size_t)(bottomUp_ ? h_ - 1 - y : y) * w_ * d_ * byteSize(); }
+		// row-major index access for contiguous array of pixel data.
+		template <typename T>
+		inline T idx(int i, int j, int k)
+		{
+			T ret;
+			memcpy(&ret, row(i) + (j * d_ * sizeof(T) + k * sizeof(T)), sizeof(T));
+			return ret;
+		}
+		// pixels holds layers images of w x h, one after the other, laid out as layout says, with rows from the
+		// bottom up when bottomUp is set.
+		inline void load(unsigned char* pixels, int w, int h, int channels, int layers = 1, Layout layout = Layout::FLAT,
+			bool bottomUp = false)
+		{
+			d_ = channels;
+			w_ = w;
+			h_ = h;
+			layers_ = layers;
+			layout_ = layout;
+			bottomUp_ = bottomUp;
+			pixels_ = pixels;
+		}
+		// Cubemap faces, volume slices or array layers all share the allocation of data(); layer(i) points at the
+		// pixels of one of them, which are laid out like those of a single image.
+		inline int layers() { return layers_; }
+		inline Layout layout() { return layout_; }
+		inline unsigned char* layer(int i) { return pixels_ + i * layerBytes(); }
+		inline size_t layerBytes() { return (size_t)w_ * h_ * d_ * byteSize(); }
+		void read(std::string filepath, const ReadOptions& options = ReadOptions());
+		inline int rows() { return h_; }
+		inline void swapBR(){for (int i = 0; i < layers_; ++i) swapBR(layer(i), w_, h_, d_, type_);}
+		inline size_t totalBytes() { return layerBytes() * layers_; }
+		inline Type type() { return type_; }
+		void write(std::string filepath, const WriteOptions& options = WriteOptions());
+		~Image(){delete[] pixels_;}
+	};
+
+	// One frame for AnimatedImage::write(): the full canvas of the animation, and how long it is shown.
+	struct AnimationFrame
+	{
+		const unsigned char* pixels = nullptr;
+		int delayMs = 100;
+	};
+
+	// Decodes an animated image a frame at a time, APNG or GIF (a PNG without animation is one frame). Every frame is
+	// the full canvas as it is shown, with the frames before it composited in, laid out as Image::read() gives images.
+	// All frames are decoded into the same buffer, so data() only holds until the next call to next() or seek().
+	// GIFs are RGB, or RGBA with ReadOptions::channels == 4, in which case pixels no frame has covered are transparent.
+	class AnimatedImage
+	{
+	public:
+		AnimatedImage();
+		~AnimatedImage();
+		AnimatedImage(const AnimatedImage&) = delete;
+		AnimatedImage& operator=(const AnimatedImage&) = delete;
+
+		// Reads the header and the list of frames; they are decoded by next().
+		void open(std::string filepath, const ReadOptions& options = ReadOptions());
+		// Decodes the next frame into data(). Returns false after the last frame, seek(0) starts over.
+		bool next();
+		// Makes frame the one the next call to next() decodes. GIF frames only decode in order, so seeking back
+		// in a GIF decodes it again from the first frame.
+		void seek(int frame);
+
+		int channels() const;
+		int cols() const;
+		int rows() const;
+		Type type() const;
+		int frameCount() const;
+		int frameIndex() const; // frame in data(), -1 before the first next()
+		int delayMs() const; // how long the frame in data() is shown
+		int loopCount() const; // how many times the animation plays, 0 forever
+		const unsigned char* data() const;
+
+		// Writes frames of w x h pixels with d channels as an animated PNG (UBYTE or USHORT) or GIF (any type, stored
+		// as 8 bits), chosen by the extension. A frame that is the same as the one before only adds to its delay, and of
+		// the others only the rectangle that changed is stored. GIF frames share one palette of WriteOptions::gifColors
+		// colors, one of them transparent, and are compressed on the thread pool. They are dithered with
+		// GifDither::ORDERED unless the options ask otherwise, as it keeps still areas the same between frames and
+		// so the changed rectangles small. GIF delays are in 10 ms steps.
+		static void write(std::string filepath, const std::vector<AnimationFrame>& frames, int w, int h, int d,
+			Type type = Type::UBYTE, int loopCount = 0, const WriteOptions& options = WriteOptions());
+
+	private:
+		struct Impl;
+		std::unique_ptr<Impl> impl_;
+	};
+
+#ifndef IMAGECODECS_NO_LIBPNG
+	// Decodes a PNG from data handed over piece by piece as it arrives, e.g. from a socket, using libpng's push
+	// reader. Rows go to the row callback as soon as they are decoded, top to bottom, laid out as Image::read()
+	// would give them. Adam7 interlaced images are delivered pass by pass (pass 0 to 6), a row again in each pass
+	// that adds pixels to it: every call passes the full row, with pixels not decoded yet filled in from the
+	// nearest decoded pixel above and to the left, so the first passes make a blocky preview of the whole image.
+	// Errors in the data, or thrown by a callback, are thrown from push(). Built on libpng, so not available when
+	// the library is built with IMAGECODECS_NO_LIBPNG (Image::read() has its own PNG decoder).
+	class PngStreamDecoder
+	{
+	public:
+		struct Info
+		{
+			int w = 0;
+			int h = 0;
+			int d = 0;
+			Type type = Type::UBYTE;
+			int passes = 1; // 7 for Adam7 interlaced images
+		};
+		// Called once the header has been read, before the first row.
+		typedef std::function<void(const Info& info)> HeaderCallback;
+		// row holds info.w pixels of info.d channels and stays valid until the callback returns.
+		typedef std::function<void(const unsigned char* row, int y, int pass)> RowCallback;
+
+		PngStreamDecoder(RowCallback onRow, HeaderCallback onHeader = nullptr, const ReadOptions& options = ReadOptions());
+		~PngStreamDecoder();
+		PngStreamDecoder(const PngStreamDecoder&) = delete;
+		PngStreamDecoder& operator=(const PngStreamDecoder&) = delete;
+
+		// Feeds the next size bytes of the file. Data after the end of the image is ignored.
+		void push(const unsigned char* data, size_t size);
+		// True once the whole image has been decoded.
+		bool done() const;
+		// Image size and layout, valid once the header callback has been called.
+		const Info& info() const;
+
+	private:
+		struct Impl;
+		std::unique_ptr<Impl> impl_;
+	};
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,139 @@
+#pragma once
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ImageCodecs
+{
+	// Read-only view of a whole file. The file is memory-mapped where the OS allows it, so decoders can walk it with a
+	// plain pointer instead of issuing a read call per field; otherwise it is read into memory in one go.
+	class MappedFile
+	{
+		const unsigned char* data_ = nullptr;
+		size_t size_ = 0;
+		std::vector<unsigned char> buffer_; // only used when mapping is not possible
+#ifdef _WIN32
+		HANDLE file_ = INVALID_HANDLE_VALUE;
+		HANDLE mapping_ = NULL;
+#else
+		void* mapped_ = nullptr;
+#endif
+
+		bool readWhole(const std::string& filepath)
+		{
+			FILE* f = fopen(filepath.c_str(), "rb");
+			if (!f)
+				return false;
+			bool ok = fseek(f, 0, SEEK_END) == 0;
+			long size = ok ? ftell(f) : -1;
+			ok = size >= 0 && fseek(f, 0, SEEK_SET) == 0;
+			if (ok)
+			{
+				buffer_.resize((size_t)size);
+				ok = fread(buffer_.data(), 1, buffer_.size(), f) == buffer_.size();
+			}
+			fclose(f);
+			if (!ok)
+				return false;
+			data_ = buffer_.data();
+			size_ = buffer_.size();
+			return true;
+		}
+
+	public:
+		MappedFile() = default;
+		explicit MappedFile(const std::string& filepath) { open(filepath); }
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		~MappedFile() { close(); }
+
+		// Returns false if the file could not be opened or read.
+		bool open(const std::string& filepath)
+		{
+			close();
+#ifdef _WIN32
+			file_ = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+			if (file_ == INVALID_HANDLE_VALUE)
+				return false;
+			LARGE_INTEGER size;
+			if (GetFileSizeEx(file_, &size) && size.QuadPart > 0 && (unsigned long long)size.QuadPart <= (size_t)-1)
+			{
+				mapping_ = CreateFileMappingA(file_, NULL, PAGE_READONLY, 0, 0, NULL);
+				if (mapping_)
+					data_ = (const unsigned char*)MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+				if (data_)
+				{
+					size_ = (size_t)size.QuadPart;
+					return true;
+				}
+			}
+			close();
+#else
+			int fd = ::open(filepath.c_str(), O_RDONLY);
+			if (fd == -1)
+				return false;
+			struct stat st;
+			if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+			{
+				void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (p != MAP_FAILED)
+				{
+					::close(fd);
+					mapped_ = p;
+					data_ = (const unsigned char*)p;
+					size_ = (size_t)st.st_size;
+					return true;
+				}
+			}
+			::close(fd);
+#endif
+			return readWhole(filepath);
+		}
+
+		void close()
+		{
+#ifdef _WIN32
+			if (mapping_)
+			{
+				if (data_ && buffer_.empty())
+					UnmapViewOfFile(data_);
+				CloseHandle(mapping_);
+				mapping_ = NULL;
+			}
+			if (file_ != INVALID_HANDLE_VALUE)
+			{
+				CloseHandle(file_);
+				file_ = INVALID_HANDLE_VALUE;
+			}
+#else
+			if (mapped_)
+			{
+				munmap(mapped_, size_);
+				mapped_ = nullptr;
+			}
+#endif
+			buffer_.clear();
+			buffer_.shrink_to_fit();
+			data_ = nullptr;
+			size_ = 0;
+		}
+
+		inline const unsigned char* data() const { return data_; }
+		inline size_t size() const { return size_; }
+	};
+}
\ No newline at end of file
@@ -0,0 +1,313 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "mipmap.h"
+#include "thread_pool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIPMAP_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace mipmap
+{
+    namespace
+    {
+        const float KAISER_RADIUS = 3.0f; // in pixels of the smaller level
+        const float KAISER_ALPHA = 4.0f;
+
+        // Source pixels and their weights for one pixel of the smaller level, along one axis. The source pixels are
+        // first to first + count - 1; weights holds count weights from offset on.
+        struct Taps
+        {
+            int first;
+            int count;
+            size_t offset;
+        };
+
+        struct Kernel
+        {
+            std::vector<Taps> taps;
+            std::vector<float> weights;
+        };
+
+        // Modified Bessel function of the first kind, order 0, for the Kaiser window.
+        double besselI0(double x)
+        {
+            double sum = 1.0, term = 1.0;
+            const double q = x * x / 4.0;
+            for (int k = 1; k < 50 && term > sum * 1e-12; ++k)
+            {
+                term *= q / ((double)k * k);
+                sum += term;
+            }
+            return sum;
+        }
+
+        double kaiser(double t)
+        {
+            const double r = t / KAISER_RADIUS;
+            if (r <= -1.0 || r >= 1.0)
+                return 0.0;
+            const double pi = 3.14159265358979323846;
+            const double sinc = t == 0.0 ? 1.0 : std::sin(pi * t) / (pi * t);
+            return sinc * besselI0(KAISER_ALPHA * std::sqrt(1.0 - r * r)) / besselI0(KAISER_ALPHA);
+        }
+
+        // Weights that take size pixels to next along one axis. Taps past the edges are folded onto the edge pixels,
+        // and the weights of every pixel sum to 1.
+        Kernel makeKernel(Filter filter, int size, int next)
+        {
+            Kernel kernel;
+            kernel.taps.resize(next);
+            const double scale = (double)size / next;
+            std::vector<double> w;
+            for (int x = 0; x < next; ++x)
+            {
+                int first, last;
+                if (filter == Filter::BOX)
+                {
+                    // the share of each source pixel that lies under [x, x + 1) scaled up to the source
+                    const double lo = x * scale, hi = (x + 1) * scale;
+                    first = (int)std::floor(lo);
+                    last = std::min(size - 1, (int)std::ceil(hi) - 1);
+                    w.assign(last - first + 1, 0.0);
+                    for (int s = first; s <= last; ++s)
+                        w[s - first] = std::min<double>(s + 1, hi) - std::max<double>(s, lo);
+                }
+                else
+                {
+                    const double center = (x + 0.5) * scale;
+                    const double radius = KAISER_RADIUS * scale;
+                    const int lo = (int)std::floor(center - radius), hi = (int)std::ceil(center + radius);
+                    first = std::max(0, lo);
+                    last = std::min(size - 1, hi);
+                    w.assign(last - first + 1, 0.0);
+                    for (int s = lo; s <= hi; ++s)
+                        w[std::min(last, std::max(first, s)) - first] += kaiser((s + 0.5 - center) / scale);
+                }
+
+                double total = 0.0;
+                for (double v : w)
+                    total += v;
+                // drop the zero weights at the ends, which the Kaiser window leaves
+                int a = 0, b = (int)w.size() - 1;
+                while (a < b && w[a] == 0.0)
+                    ++a;
+                while (b > a && w[b] == 0.0)
+                    --b;
+                Taps& taps = kernel.taps[x];
+                taps.first = first + a;
+                taps.count = b - a + 1;
+                taps.offset = kernel.weights.size();
+                for (int i = a; i <= b; ++i)
+                    kernel.weights.push_back((float)(w[i] / total));
+            }
+            return kernel;
+        }
+
+        double srgbToLinear(double v)
+        {
+            return v <= 0.04045 ? v / 12.92 : std::pow((v + 0.055) / 1.055, 2.4);
+        }
+
+        double linearToSrgb(double v)
+        {
+            return v <= 0.0031308 ? v * 12.92 : 1.055 * std::pow(v, 1.0 / 2.4) - 0.055;
+        }
+
+        const float* srgbTable8()
+        {
+            static const std::vector<float> table = [] {
+                std::vector<float> t(256);
+                for (int i = 0; i < 256; ++i)
+                    t[i] = (float)srgbToLinear(i / 255.0);
+                return t;
+            }();
+            return table.data();
+        }
+
+        const float* srgbTable16()
+        {
+            static const std::vector<float> table = [] {
+                std::vector<float> t(65536);
+                for (int i = 0; i < 65536; ++i)
+                    t[i] = (float)srgbToLinear(i / 65535.0);
+                return t;
+            }();
+            return table.data();
+        }
+
+        // 8-bit sRGB of linear values in 1/65535 steps, which are fine enough to tell apart the darkest sRGB values,
+        // where linear light changes the least between them.
+        const uint8_t* linearTable8()
+        {
+            static const std::vector<uint8_t> table = [] {
+                std::vector<uint8_t> t(65536);
+                for (int i = 0; i < 65536; ++i)
+                    t[i] = (uint8_t)std::lround(255.0 * linearToSrgb(i / 65535.0));
+                return t;
+            }();
+            return table.data();
+        }
+
+        // Gray + alpha and RGBA keep alpha in their last channel.
+        inline bool hasAlpha(int channels)
+        {
+            return channels == 2 || channels == 4;
+        }
+
+        // One row of w pixels as linear floats.
+        void loadRow(const uint8_t* row, int w, int channels, int bytesPerChannel, float* out)
+        {
+            const int n = w * channels;
+            if (bytesPerChannel == 4)
+            {
+                memcpy(out, row, n * sizeof(float));
+                return;
+            }
+            if (bytesPerChannel == 1)
+            {
+                const float* table = srgbTable8();
+                for (int i = 0; i < n; ++i)
+                    out[i] = table[row[i]];
+                if (hasAlpha(channels))
+                    for (int i = channels - 1; i < n; i += channels)
+                        out[i] = row[i] * (1.0f / 255.0f);
+                return;
+            }
+            const float* table = srgbTable16();
+            for (int i = 0; i < n; ++i)
+            {
+                uint16_t v;
+                memcpy(&v, row + 2 * i, 2);
+                out[i] = table[v];
+                if (hasAlpha(channels) && i % channels == channels - 1)
+                    out[i] = v * (1.0f / 65535.0f);
+            }
+        }
+
+        // Linear floats back to one row of w pixels.
+        void storeRow(const float* in, int w, int channels, int bytesPerChannel, uint8_t* row)
+        {
+            const int n = w * channels;
+            if (bytesPerChannel == 4)
+            {
+                memcpy(row, in, n * sizeof(float));
+                return;
+            }
+            if (bytesPerChannel == 1)
+            {
+                const uint8_t* table = linearTable8();
+                for (int i = 0; i < n; ++i)
+                    row[i] = table[(int)(std::min(1.0f, std::max(0.0f, in[i])) * 65535.0f + 0.5f)];
+                if (hasAlpha(channels))
+                    for (int i = channels - 1; i < n; i += channels)
+                        row[i] = (uint8_t)(std::min(1.0f, std::max(0.0f, in[i])) * 255.0f + 0.5f);
+                return;
+            }
+            for (int i = 0; i < n; ++i)
+            {
+                const float v = std::min(1.0f, std::max(0.0f, in[i]));
+                const double s = hasAlpha(channels) && i % channels == channels - 1 ? v : linearToSrgb(v);
+                const uint16_t out = (uint16_t)(s * 65535.0 + 0.5);
+                memcpy(row + 2 * i, &out, 2);
+            }
+        }
+
+        // Filters one linear row across into the pixels of the smaller level.
+        void filterRow(const float* src, int channels, const Kernel& kernel, float* out)
+        {
+            const int next = (int)kernel.taps.size();
+            for (int x = 0; x < next; ++x)
+            {
+                const Taps& taps = kernel.taps[x];
+                const float* weights = &kernel.weights[taps.offset];
+                const float* s = src + (size_t)taps.first * channels;
+#ifdef MIPMAP_SSE2
+                if (channels == 4)
+                {
+                    __m128 acc = _mm_setzero_ps();
+                    for (int i = 0; i < taps.count; ++i)
+                        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(weights[i]), _mm_loadu_ps(s + 4 * i)));
+                    _mm_storeu_ps(out + 4 * x, acc);
+                    continue;
+                }
+#endif
+                for (int c = 0; c < channels; ++c)
+                {
+                    float acc = 0.0f;
+                    for (int i = 0; i < taps.count; ++i)
+                        acc += weights[i] * s[i * channels + c];
+                    out[x * channels + c] = acc;
+                }
+            }
+        }
+
+        // out += weight * row, for n values.
+        void accumulate(float* out, const float* row, float weight, size_t n)
+        {
+            size_t i = 0;
+#ifdef MIPMAP_SSE2
+            const __m128 w = _mm_set1_ps(weight);
+            for (; i + 4 <= n; i += 4)
+                _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(w, _mm_loadu_ps(row + i))));
+#endif
+            for (; i < n; ++i)
+                out[i] += weight * row[i];
+        }
+    }
+
+    int levelCount(int w, int h)
+    {
+        int levels = 1;
+        for (int size = std::max(w, h); size > 1; size /= 2)
+            ++levels;
+        return levels;
+    }
+
+    void downsample(Filter filter, const uint8_t* pixels, int w, int h, int channels, int bytesPerChannel,
+        uint8_t* next, unsigned numThreads)
+    {
+        const int nw = nextSize(w), nh = nextSize(h);
+        const Kernel across = makeKernel(filter, w, nw);
+        const Kernel down = makeKernel(filter, h, nh);
+        const size_t srcRowBytes = (size_t)w * channels * bytesPerChannel;
+        const size_t dstRowBytes = (size_t)nw * channels * bytesPerChannel;
+        const size_t rowValues = (size_t)nw * channels;
+
+        // Each band of rows of the smaller level filters the source rows under it across into a scratch buffer of
+        // about 256 KB, then down into its own rows, so the rows are only read from memory once while they are hot.
+        const int band = std::max(1, std::min(nh, (int)(65536 / (rowValues * (size_t)std::max(1, h / nh) + 1))));
+        const size_t numBands = ((size_t)nh + band - 1) / band;
+        ImageCodecs::ThreadPool::global().parallelFor(0, numBands, [&](size_t b) {
+            const int y0 = (int)b * band;
+            const int y1 = std::min(nh, y0 + band);
+            const int srcFirst = down.taps[y0].first;
+            int srcEnd = srcFirst;
+            for (int y = y0; y < y1; ++y)
+                srcEnd = std::max(srcEnd, down.taps[y].first + down.taps[y].count);
+
+            std::vector<float> linear((size_t)w * channels);
+            std::vector<float> filtered((size_t)(srcEnd - srcFirst) * rowValues);
+            for (int sy = srcFirst; sy < srcEnd; ++sy)
+            {
+                loadRow(pixels + (size_t)sy * srcRowBytes, w, channels, bytesPerChannel, linear.data());
+                filterRow(linear.data(), channels, across, &filtered[(size_t)(sy - srcFirst) * rowValues]);
+            }
+
+            std::vector<float> row(rowValues);
+            for (int y = y0; y < y1; ++y)
+            {
+                const Taps& taps = down.taps[y];
+                const float* weights = &down.weights[taps.offset];
+                std::fill(row.begin(), row.end(), 0.0f);
+                for (int i = 0; i < taps.count; ++i)
+                    accumulate(row.data(), &filtered[(size_t)(taps.first + i - srcFirst) * rowValues], weights[i], rowValues);
+                storeRow(row.data(), nw, channels, bytesPerChannel, next + (size_t)y * dstRowBytes);
+            }
+        }, numThreads);
+    }
+}
\ No newline at end of file
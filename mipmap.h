@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace mipmap
+{
+    // How each mipmap level is made from the one above it.
+    enum class Filter
+    {
+        BOX,   // average of the 2x2 pixels (or the area, for odd sizes) under each pixel: fast, slightly soft
+        KAISER // Kaiser windowed sinc over 6 pixels each way: sharper, with less aliasing of fine detail
+    };
+
+    // Levels of a full mipmap chain for a w x h image, the image itself included: 1 + log2 of the larger side.
+    int levelCount(int w, int h);
+    // Size of the level below one of w x h pixels: halved, rounded down, but never below 1.
+    inline int nextSize(int size) { return size > 1 ? size / 2 : 1; }
+
+    // Filters w x h pixels of channels (1 to 4) values of bytesPerChannel each, rows top to bottom, into the
+    // nextSize(w) x nextSize(h) pixels of the next level. 1 and 2 byte values are treated as sRGB and filtered in
+    // linear light, except alpha (the last channel of 2 and 4 channel images), which is linear already; 4 byte values
+    // are floats, already linear, and are not clamped. The image is filtered in tiles of a few rows that stay in
+    // cache, on numThreads threads of the shared pool, 0 for the whole pool.
+    void downsample(Filter filter, const uint8_t* pixels, int w, int h, int channels, int bytesPerChannel,
+        uint8_t* next, unsigned numThreads = 0);
+}
\ No newline at end of file
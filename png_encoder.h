@@ -1,9 +1,123 @@
-#include <cstdint>
-#include <string>
-#include <vector>
-
-namespace png_encoder
-{
-    // Code adapted from: https://github.com/lvandeve/lodepng/
-    void saveToFile(std::string filepath, unsigned char* pixels, int w, int h, int d);
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace png_encoder
+{
+    // How LZ77 matches are searched for, on top of what the compression level selects.
+    enum class Strategy
+    {
+        DEFAULT,      // as selected by the level
+        RLE,          // only runs of the same byte: very fast, good on flat images such as screenshots
+        HUFFMAN_ONLY  // no LZ77 at all: fastest, largest files
+    };
+
+    struct Options
+    {
+        // zlib-like compression level, from 0 (stored, fastest) to 9 (smallest, slowest). 1 and 2 use a greedy
+        // single probe matcher; 6 is the classic lodepng default.
+        unsigned level = 6;
+        Strategy strategy = Strategy::DEFAULT;
+        // Size of the IDAT chunks that the compressed image data is split into.
+        size_t idatChunkSize = 65536;
+        // Threads used to deflate independent chunks of the image data at the same time. 0 uses the whole shared
+        // thread pool, 1 compresses the same chunks one after the other on the calling thread, so the written file
+        // doesn't depend on it.
+        unsigned numThreads = 0;
+        // Lets saveToFile() store the image as palette, gray or with a color key when that is lossless and smaller.
+        // When false the PNG keeps the color type of the pixels, which also skips the pass over the image that
+        // gathers the color statistics.
+        bool autoConvert = true;
+    };
+
+    // Writes a PNG a band of rows at a time: rows are filtered and deflated as they are given and go out to the
+    // sink as IDAT chunks, so memory use stays at a few MB whatever the size of the image. Call begin(), then
+    // writeRows() until all h rows are given, top to bottom, then finish(). The functions return an error code,
+    // 0 on success. Rows have d channels (1 gray, 2 gray + alpha, 3 RGB, 4 RGBA) of bitDepth 8 or 16 bits, 16-bit
+    // values in native byte order as in an Image of Type::USHORT. The PNG keeps that color type.
+    class StreamEncoder
+    {
+    public:
+        // Receives the bytes of the PNG in order; returning false aborts with an error.
+        typedef std::function<bool(const unsigned char* data, size_t size)> Sink;
+
+        StreamEncoder();
+        ~StreamEncoder();
+        StreamEncoder(const StreamEncoder&) = delete;
+        StreamEncoder& operator=(const StreamEncoder&) = delete;
+
+        unsigned begin(Sink sink, int w, int h, int d, int bitDepth, const Options& options = Options());
+        unsigned writeRows(const unsigned char* rows, int numRows);
+        unsigned finish();
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> impl_;
+    };
+
+    // Code adapted from: https://github.com/lvandeve/lodepng/
+    // Streams the image to the file, picking a palette or gray color type when that is lossless (see
+    // Options::autoConvert). Pixels are laid out as for StreamEncoder. Returns an error code, 0 on success.
+    unsigned saveToFile(std::string filepath, const unsigned char* pixels, int w, int h, int d, int bitDepth,
+        const Options& options = Options());
+
+    // Writes an animated PNG (APNG) of numFrames frames, each a full w x h image laid out as for StreamEncoder that is
+    // shown for delaysMs[i] milliseconds. numPlays 0 loops forever. A frame that is the same as the one before only
+    // adds to its delay, of the others only the rectangle that changed is stored, and with an alpha channel the pixels
+    // in it that didn't change are stored transparent and blended over the previous frame. All frames share one color
+    // type, picked from all of them as saveToFile() does. Returns an error code, 0 on success.
+    unsigned saveAnimationToFile(std::string filepath, const unsigned char* const* frames, const int* delaysMs,
+        int numFrames, int w, int h, int d, int bitDepth, unsigned numPlays = 0, const Options& options = Options());
+
+    // Built-in decoder, no libpng or zlib needed. inspect() reads the header of the PNG in data and gives the size
+    // and layout decode() will produce: d channels (with channels == 0 those of the file, palettes as RGB or RGBA when
+    // they have transparency, and a tRNS color key as an extra alpha channel; with channels == 4 always RGBA) of
+    // bitDepth 8, or 16 for 16-bit files. Both return an error code, 0 on success.
+    unsigned inspect(const unsigned char* data, size_t size, int& w, int& h, int& d, int& bitDepth, int channels = 0);
+    // Decodes the PNG in data into pixels, which must hold w * h * d * bitDepth / 8 bytes as given by inspect(). Rows go
+    // top to bottom, 16-bit values are in native byte order as in an Image of Type::USHORT. Adam7 is supported.
+    unsigned decode(unsigned char* pixels, const unsigned char* data, size_t size, int channels = 0);
+
+    // Built-in APNG decoder. Frames are decoded one at a time onto a canvas of the size of the image, which after next()
+    // holds the frame as it is shown, with the frames before it composited in. The canvas is laid out as decode() gives
+    // images, in the d channels inspect() would give. A PNG that is not animated is an animation of one frame. The
+    // functions returning unsigned return an error code, 0 on success.
+    class AnimationDecoder
+    {
+    public:
+        AnimationDecoder();
+        ~AnimationDecoder();
+        AnimationDecoder(const AnimationDecoder&) = delete;
+        AnimationDecoder& operator=(const AnimationDecoder&) = delete;
+
+        // Reads the header and the list of frames. data must stay valid while frames are decoded.
+        unsigned open(const unsigned char* data, size_t size, int channels = 0);
+        // Decodes the next frame onto the canvas, going back to the first after the last.
+        unsigned next();
+        // Makes frame the one next() decodes. The frames it depends on are decoded again, starting at the last frame
+        // before it that replaces the whole canvas.
+        unsigned seek(int frame);
+
+        int w() const;
+        int h() const;
+        int d() const;
+        int bitDepth() const;
+        int numFrames() const;
+        unsigned numPlays() const; // 0 loops forever
+        int frameIndex() const; // frame on the canvas, -1 when there is none
+        int delayMs() const; // how long the frame on the canvas is shown
+        const unsigned char* canvas() const;
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> impl_;
+    };
+
+    // Copies count 16-bit values from in to out with their bytes swapped (native <-> PNG big endian), with SSE2
+    // where available. in and out may be the same.
+    void swapBytes16(const unsigned char* in, unsigned char* out, size_t count);
 }
\ No newline at end of file
@@ -1,151 +1,1429 @@
-// Include opencv4 to display images
-#include <opencv2/opencv.hpp>
-#include <opencv2/highgui.hpp>
-#pragma comment(lib, "libwebp.lib")
-#pragma comment(lib, "libsharpyuv.lib")
-#ifdef NDEBUG
-#pragma comment(lib, "opencv_core4.lib")
-#pragma comment(lib, "opencv_highgui4.lib")
-#pragma comment(lib, "opencv_imgcodecs4.lib")
-#pragma comment(lib, "opencv_imgproc4.lib")
-#else
-#pragma comment(lib, "opencv_core4d.lib")
-#pragma comment(lib, "opencv_highgui4d.lib")
-#pragma comment(lib, "opencv_imgcodecs4d.lib")
-#pragma comment(lib, "opencv_imgproc4d.lib")
-#endif
-
-#include "codecs.h"
-
-#include <iostream>
-#include <filesystem>
-#include <fstream>
-#include <string>
-
-
-//#define _DISPLAY_RESULTS // <-- uncomment to display images in window to manually verify appearance
-
-
-void displayResult(std::string filepath, ImageCodecs::Image& img)
-{
-	int typ = 0;
-	switch (img.channels())
-	{
-	case 1:
-		typ = CV_8UC1;
-		break;
-	case 3:
-		typ = CV_8UC3;
-		break;
-	default:
-		typ = CV_8UC4;
-		break;
-	}
-	if (img.type() == ImageCodecs::Type::FLOAT)
-	{
-		switch (img.channels())
-		{
-		case 1:
-			typ = CV_32FC1;
-			break;
-		case 3:
-			typ = CV_32FC3;
-			break;
-		default:
-			typ = CV_32FC4;
-			break;
-		}
-	}
-	cv::Mat displayImg = cv::Mat::zeros(img.rows(), img.cols(), typ);
-	memcpy(displayImg.data, *img.data(), img.cols() * img.rows() * img.channels() * (img.type() == ImageCodecs::Type::FLOAT ? 4 : 1));
-	if (img.type() == ImageCodecs::Type::FLOAT)
-	{
-		if (displayImg.channels() != 3)
-		{
-			if (displayImg.channels() == 1)
-				cv::cvtColor(displayImg, displayImg, cv::COLOR_GRAY2RGB);
-			else if (displayImg.channels() == 4)
-				cv::cvtColor(displayImg, displayImg, cv::COLOR_RGBA2RGB);
-		}
-		displayImg.convertTo(displayImg, CV_8UC3, 255.0);
-	}
-	cv::imshow(filepath, displayImg);
-	cv::waitKey();
-	displayImg.deallocate();
-}
-
-
-int main(int argc, char** argv)
-{
-	if (!std::filesystem::exists("test"))
-	{
-		std::filesystem::create_directory("test");
-	}
-
-	for (auto& testFile : std::filesystem::recursive_directory_iterator("data"))
-	{
-		try
-		{
-			ImageCodecs::Image img;
-
-			// Test .read()
-			std::cout << "reading from disk: " << testFile.path().string() << std::endl;
-			img.read(testFile.path().string());
-
-			// Display read pixels.
-			if (!img.empty())
-			{
-#ifdef _DISPLAY_RESULTS
-				displayResult(testFile.path().string(), img);
-#endif
-			}
-
-			// Test .write()
-			auto parent = testFile.path().parent_path();
-			auto newName = testFile.path().filename().string();
-			auto ext = testFile.path().extension().string();
-			newName = "test\\" + newName.substr(0, newName.rfind(".")) + "_icdTest" + ext;
-			img.write(newName);
-		}
-		catch (std::exception& e)
-		{
-			std::cerr << e.what() << std::endl;
-		}
-	}
-
-
-	// Now try to 'read' all the newly written test files.
-	for (auto& testFile : std::filesystem::recursive_directory_iterator("test"))
-	{
-		try
-		{
-			ImageCodecs::Image img;
-
-			// Test .read()
-			std::cout << "reading from disk: " << testFile.path().string() << std::endl;
-			img.read(testFile.path().string());
-
-			// Display read pixels.
-			if (!img.empty())
-			{
-#ifdef _DISPLAY_RESULTS
-				displayResult(testFile.path().string(), img);
-#endif
-			}
-
-
-			// Test .write()
-			auto parent = testFile.path().parent_path();
-			auto newName = testFile.path().filename().string();
-			auto ext = testFile.path().extension().string();
-			newName = "test2\\" + newName.substr(0, newName.rfind(".")) + "_icdTest" + ext;
-			img.write(newName);
-		}
-		catch (std::exception& e)
-		{
-			std::cerr << e.what() << std::endl;
-		}
-	}
-
-	return EXIT_SUCCESS;
+// Include opencv4 to display images
+#include <opencv2/opencv.hpp>
+#include <opencv2/highgui.hpp>
+#pragma comment(lib, "libwebp.lib")
+#pragma comment(lib, "libsharpyuv.lib")
+#ifdef NDEBUG
+#pragma comment(lib, "opencv_core4.lib")
+#pragma comment(lib, "opencv_highgui4.lib")
+#pragma comment(lib, "opencv_imgcodecs4.lib")
+#pragma comment(lib, "opencv_imgproc4.lib")
+#else
+#pragma comment(lib, "opencv_core4d.lib")
+#pragma comment(lib, "opencv_highgui4d.lib")
+#pragma comment(lib, "opencv_imgcodecs4d.lib")
+#pragma comment(lib, "opencv_imgproc4d.lib")
+#endif
+
+#include "bcn.h"
+#include "codecs.h"
+#include "gif.h"
+#include "nv_dds.h"
+#include "png_encoder.h"
+#include "tinyexr.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+
+//#define _DISPLAY_RESULTS // <-- uncomment to display images in window to manually verify appearance
+
+
+void displayResult(std::string filepath, ImageCodecs::Image& img)
+{
+	int typ = 0;
+	switch (img.channels())
+	{
+	case 1:
+		typ = CV_8UC1;
+		break;
+	case 3:
+		typ = CV_8UC3;
+		break;
+	default:
+		typ = CV_8UC4;
+		break;
+	}
+	if (img.type() == ImageCodecs::Type::FLOAT)
+	{
+		switch (img.channels())
+		{
+		case 1:
+			typ = CV_32FC1;
+			break;
+		case 3:
+			typ = CV_32FC3;
+			break;
+		default:
+			typ = CV_32FC4;
+			break;
+		}
+	}
+	cv::Mat displayImg = cv::Mat::zeros(img.rows(), img.cols(), typ);
+	memcpy(displayImg.data, *img.data(), img.cols() * img.rows() * img.channels() * (img.type() == ImageCodecs::Type::FLOAT ? 4 : 1));
+	if (img.bottomUp())
+		cv::flip(displayImg, displayImg, 0);
+	if (img.type() == ImageCodecs::Type::FLOAT)
+	{
+		if (displayImg.channels() != 3)
+		{
+			if (displayImg.channels() == 1)
+				cv::cvtColor(displayImg, displayImg, cv::COLOR_GRAY2RGB);
+			else if (displayImg.channels() == 4)
+				cv::cvtColor(displayImg, displayImg, cv::COLOR_RGBA2RGB);
+		}
+		displayImg.convertTo(displayImg, CV_8UC3, 255.0);
+	}
+	cv::imshow(filepath, displayImg);
+	cv::waitKey();
+	displayImg.deallocate();
+}
+
+
+static int failures = 0;
+
+// Reports a check that failed; main() returns EXIT_FAILURE when there was any.
+void check(bool ok, const std::string& what)
+{
+	if (!ok)
+	{
+		std::cerr << "FAILED: " << what << std::endl;
+		++failures;
+	}
+}
+
+std::vector<unsigned char> readFile(const std::filesystem::path& filepath)
+{
+	std::ifstream file(filepath, std::ios::binary);
+	return std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// A w x h test image of d channels: gradients with a little noise, which compress, but not to nothing. 16-bit values
+// are in native byte order, with low bytes that keep them from being stored as 8 bits.
+std::vector<unsigned char> testPixels(int w, int h, int d, int bitDepth, unsigned seed)
+{
+	std::mt19937 rng(seed);
+	std::vector<unsigned char> pixels((size_t)w * h * d * (bitDepth / 8));
+	for (size_t i = 0; i < (size_t)w * h * d; ++i)
+	{
+		const int x = (int)(i / d % w), y = (int)(i / d / w), c = (int)(i % d);
+		const unsigned v = (x * 3 + y * 5 + c * 60 + rng() % 8) & 255;
+		if (bitDepth == 16)
+		{
+			const uint16_t v16 = (uint16_t)(v << 8 | rng() % 256);
+			memcpy(&pixels[i * 2], &v16, 2);
+		}
+		else
+			pixels[i] = (unsigned char)v;
+	}
+	return pixels;
+}
+
+// Decodes a PNG with the built-in decoder, asking for the given number of channels (0 for those of the file) and
+// checking that it comes out as w x h pixels of d channels of bitDepth bits.
+std::vector<unsigned char> decodePng(const std::vector<unsigned char>& png, int w, int h, int d, int bitDepth,
+	const std::string& what, int channels = 0)
+{
+	int pw = 0, ph = 0, pd = 0, pBitDepth = 0;
+	std::vector<unsigned char> pixels;
+	if (png_encoder::inspect(png.data(), png.size(), pw, ph, pd, pBitDepth, channels) != 0)
+	{
+		check(false, what + ": inspect");
+		return pixels;
+	}
+	check(pw == w && ph == h && pd == d && pBitDepth == bitDepth, what + ": size and layout");
+	pixels.resize((size_t)pw * ph * pd * (pBitDepth / 8));
+	check(png_encoder::decode(pixels.data(), png.data(), png.size(), channels) == 0, what + ": decode");
+	return pixels;
+}
+
+// Images big enough to be deflated as several chunks give the same file on any number of threads, which decodes to the
+// pixels that went in.
+void testPngThreads()
+{
+	std::cout << "testing PNG chunked deflate" << std::endl;
+	const int w = 320, h = 240;
+	const auto filepath = std::filesystem::temp_directory_path() / "imagecodecs_test.png";
+	for (int d : { 3, 4 })
+	{
+		const std::string what = "PNG of " + std::to_string(d) + " channels";
+		std::vector<unsigned char> pixels = testPixels(w, h, d, 8, d);
+		std::vector<unsigned char> files[4];
+		const unsigned numThreads[] = { 0, 1, 2, 3 };
+		for (int i = 0; i < 4; ++i)
+		{
+			png_encoder::Options options;
+			options.numThreads = numThreads[i];
+			png_encoder::saveToFile(filepath.string(), pixels.data(), w, h, d, 8, options);
+			files[i] = readFile(filepath);
+		}
+		check(files[0] == files[1] && files[0] == files[2] && files[0] == files[3],
+			what + ": the same file on any number of threads");
+		check(decodePng(files[0], w, h, d, 8, what) == pixels, what + ": round trip");
+	}
+	std::filesystem::remove(filepath);
+}
+
+// Every level and strategy gives a PNG that decodes to the pixels that went in, and every level but 0, which stores the
+// data, compresses it.
+void testPngLevels()
+{
+	std::cout << "testing PNG compression levels" << std::endl;
+	const int w = 160, h = 120;
+	const png_encoder::Strategy strategies[] = { png_encoder::Strategy::DEFAULT, png_encoder::Strategy::RLE,
+		png_encoder::Strategy::HUFFMAN_ONLY };
+	const auto filepath = std::filesystem::temp_directory_path() / "imagecodecs_test.png";
+	for (int d : { 3, 4 })
+	{
+		std::vector<unsigned char> pixels = testPixels(w, h, d, 8, 10 + d);
+		size_t sizes[10] = {};
+		for (int s = 0; s < 3; ++s)
+		{
+			for (unsigned level = 0; level <= 9; ++level)
+			{
+				const std::string what = "PNG of " + std::to_string(d) + " channels, strategy " + std::to_string(s) +
+					" level " + std::to_string(level);
+				png_encoder::Options options;
+				options.level = level;
+				options.strategy = strategies[s];
+				png_encoder::saveToFile(filepath.string(), pixels.data(), w, h, d, 8, options);
+				const std::vector<unsigned char> png = readFile(filepath);
+				check(decodePng(png, w, h, d, 8, what) == pixels, what + ": round trip");
+				if (s == 0)
+					sizes[level] = png.size();
+			}
+		}
+		check(*std::max_element(sizes + 1, sizes + 10) < sizes[0], "PNG of " + std::to_string(d) + " channels: compressed");
+	}
+	std::filesystem::remove(filepath);
+}
+
+// Rows of every width up to a few vectors and then some, so that the filters and the filter choice run through both
+// their vector loops and the pixels left over after them.
+void testPngFilters()
+{
+	std::cout << "testing PNG filters" << std::endl;
+	const auto filepath = std::filesystem::temp_directory_path() / "imagecodecs_test.png";
+	for (int d : { 3, 4 })
+	{
+		for (int w = 1; w <= 70; w += w < 20 ? 1 : 7)
+		{
+			const int h = 9;
+			const std::string what = "PNG of " + std::to_string(d) + " channels, " + std::to_string(w) + " wide";
+			std::vector<unsigned char> pixels = testPixels(w, h, d, 8, w);
+			png_encoder::Options options;
+			options.level = 1;
+			png_encoder::saveToFile(filepath.string(), pixels.data(), w, h, d, 8, options);
+			check(decodePng(readFile(filepath), w, h, d, 8, what) == pixels, what + ": round trip");
+		}
+	}
+	std::filesystem::remove(filepath);
+}
+
+// StreamEncoder gives the same PNG whether the rows come one at a time or in bands of any height, with its image data
+// split into IDAT chunks of the size asked for, and a sink that fails stops it with an error.
+void testPngStreamEncoder()
+{
+	std::cout << "testing PNG stream encoder" << std::endl;
+	const int w = 200, h = 150;
+	for (int d : { 3, 4 })
+	{
+		const std::string what = "PNG stream of " + std::to_string(d) + " channels";
+		const std::vector<unsigned char> pixels = testPixels(w, h, d, 8, 20 + d);
+		const size_t rowBytes = (size_t)w * d;
+		png_encoder::Options options;
+		options.idatChunkSize = 4096;
+		auto encode = [&](int band, const png_encoder::StreamEncoder::Sink& sink) {
+			png_encoder::StreamEncoder encoder;
+			unsigned err = encoder.begin(sink, w, h, d, 8, options);
+			for (int y = 0; y < h && !err; y += band)
+				err = encoder.writeRows(&pixels[y * rowBytes], std::min(band, h - y));
+			return err ? err : encoder.finish();
+		};
+
+		std::vector<unsigned char> files[3];
+		const int bands[] = { 1, 16, h };
+		for (int i = 0; i < 3; ++i)
+		{
+			std::vector<unsigned char>& file = files[i];
+			check(encode(bands[i], [&](const unsigned char* data, size_t size) {
+				file.insert(file.end(), data, data + size);
+				return true;
+			}) == 0, what + ": encode");
+		}
+		check(files[0] == files[1] && files[0] == files[2], what + ": the same file for any band of rows");
+		check(decodePng(files[0], w, h, d, 8, what) == pixels, what + ": round trip");
+
+		int idatChunks = 0;
+		bool chunkSizes = true;
+		for (size_t pos = 8; pos + 12 <= files[0].size();)
+		{
+			const unsigned char* chunk = &files[0][pos];
+			const size_t length = (size_t)chunk[0] << 24 | chunk[1] << 16 | chunk[2] << 8 | chunk[3];
+			if (memcmp(chunk + 4, "IDAT", 4) == 0)
+			{
+				++idatChunks;
+				chunkSizes = chunkSizes && length <= options.idatChunkSize;
+			}
+			pos += length + 12;
+		}
+		check(idatChunks > 1 && chunkSizes, what + ": IDAT chunks");
+
+		size_t written = 0;
+		check(encode(16, [&](const unsigned char*, size_t size) {
+			written += size;
+			return written < 1000;
+		}) != 0, what + ": a failing sink stops the encoder");
+	}
+}
+
+// 16-bit images of every layout through saveToFile() and back, and through Image, which reads them as Type::USHORT and
+// writes them as they were.
+void testPng16Bit()
+{
+	std::cout << "testing 16-bit PNG" << std::endl;
+	const int w = 45, h = 31;
+	const auto filepath = std::filesystem::temp_directory_path() / "imagecodecs_test.png";
+	const auto copyPath = std::filesystem::temp_directory_path() / "imagecodecs_copy.png";
+	for (int d = 1; d <= 4; ++d)
+	{
+		const std::string what = "16-bit PNG of " + std::to_string(d) + " channels";
+		const std::vector<unsigned char> pixels = testPixels(w, h, d, 16, 30 + d);
+		check(png_encoder::saveToFile(filepath.string(), pixels.data(), w, h, d, 16) == 0, what + ": save");
+		check(decodePng(readFile(filepath), w, h, d, 16, what) == pixels, what + ": round trip");
+
+		ImageCodecs::Image image;
+		image.read(filepath.string());
+		check(image.type() == ImageCodecs::Type::USHORT && image.channels() == d && image.cols() == w &&
+			image.rows() == h && memcmp(*image.data(), pixels.data(), pixels.size()) == 0, what + ": Image read");
+		image.write(copyPath.string());
+		check(decodePng(readFile(copyPath), w, h, d, 16, what) == pixels, what + ": Image write");
+	}
+	std::filesystem::remove(filepath);
+	std::filesystem::remove(copyPath);
+}
+
+#ifndef IMAGECODECS_NO_LIBPNG
+// A PNG handed to PngStreamDecoder a few bytes at a time comes out row by row as it went in.
+void testPngStreamDecoder()
+{
+	std::cout << "testing PngStreamDecoder" << std::endl;
+	const int w = 50, h = 20, d = 3;
+	const std::vector<unsigned char> pixels = testPixels(w, h, d, 16, 4);
+	const auto filepath = std::filesystem::temp_directory_path() / "imagecodecs_test.png";
+	png_encoder::Options options;
+	options.autoConvert = false;
+	check(png_encoder::saveToFile(filepath.string(), pixels.data(), w, h, d, 16, options) == 0, "PNG stream: save");
+	std::vector<unsigned char> png = readFile(filepath);
+	std::filesystem::remove(filepath);
+
+	std::vector<unsigned char> rows(pixels.size());
+	const size_t rowBytes = (size_t)w * d * 2;
+	ImageCodecs::PngStreamDecoder decoder([&](const unsigned char* row, int y, int) {
+		memcpy(&rows[y * rowBytes], row, rowBytes);
+	});
+	for (size_t i = 0; i < png.size(); i += 7)
+		decoder.push(&png[i], std::min((size_t)7, png.size() - i));
+	check(decoder.done() && decoder.info().w == w && decoder.info().h == h && decoder.info().d == d &&
+		decoder.info().type == ImageCodecs::Type::USHORT, "PNG stream: header");
+	check(rows == pixels, "PNG stream: rows");
+
+	// Broken data makes push() throw.
+	png[png.size() / 2] ^= 1;
+	bool threw = false;
+	try
+	{
+		ImageCodecs::PngStreamDecoder broken([](const unsigned char*, int, int) {});
+		broken.push(png.data(), png.size());
+	}
+	catch (std::exception&)
+	{
+		threw = true;
+	}
+	check(threw, "PNG stream: broken data throws");
+}
+#endif
+
+// Whether reading the file throws, as every broken file should.
+bool readThrows(const std::filesystem::path& filepath)
+{
+	try
+	{
+		ImageCodecs::Image img;
+		img.read(filepath.string());
+	}
+	catch (std::exception&)
+	{
+		return true;
+	}
+	return false;
+}
+
+// The CRC-32 PNG chunks end with.
+unsigned crc32(const unsigned char* data, size_t size)
+{
+	unsigned crc = 0xffffffffu;
+	for (size_t i = 0; i < size; ++i)
+	{
+		crc ^= data[i];
+		for (int k = 0; k < 8; ++k)
+			crc = (crc >> 1) ^ (0xedb88320u & (0u - (crc & 1)));
+	}
+	return ~crc;
+}
+
+// Appends v as PNG stores it, big-endian.
+void put32(std::vector<unsigned char>& out, unsigned v)
+{
+	for (int shift = 24; shift >= 0; shift -= 8)
+		out.push_back((unsigned char)(v >> shift));
+}
+
+// An 8-bit RGB PNG of w x h pixels with the zlib stream as its only IDAT chunk.
+std::vector<unsigned char> makePng(int w, int h, const std::vector<unsigned char>& zlib)
+{
+	const unsigned char signature[] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+	std::vector<unsigned char> png(signature, signature + 8), header;
+	put32(header, w);
+	put32(header, h);
+	header.insert(header.end(), { 8, 2, 0, 0, 0 });
+	auto chunk = [&](const char* type, const std::vector<unsigned char>& data) {
+		put32(png, (unsigned)data.size());
+		const size_t start = png.size();
+		png.insert(png.end(), type, type + 4);
+		png.insert(png.end(), data.begin(), data.end());
+		put32(png, crc32(&png[start], png.size() - start));
+	};
+	chunk("IHDR", header);
+	chunk("IDAT", zlib);
+	chunk("IEND", {});
+	return png;
+}
+
+// A zlib stream made by zlib itself (level 9, fixed Huffman codes) of a 16 x 8 RGB image whose rows use the five
+// filter types in turn, and broken copies of it, which have to fail to decode rather than crash.
+void testPngKnownAnswer()
+{
+	std::cout << "testing PNG known answer and broken files" << std::endl;
+	const unsigned char zlib[] = {
+		0x78, 0xda, 0x63, 0x60, 0x08, 0x58, 0xc0, 0x12, 0xb2, 0x84, 0x23, 0x62, 0x05, 0x4f, 0xcc, 0x1a,
+		0x20, 0x12, 0x48, 0xd8, 0x20, 0x92, 0xb2, 0x45, 0x22, 0x63, 0x07, 0x10, 0xc9, 0xe4, 0xec, 0x51,
+		0x28, 0x38, 0xa0, 0x52, 0x72, 0x04, 0x88, 0x34, 0x2a, 0x4e, 0xe8, 0xd4, 0x9c, 0x31, 0x68, 0xb8,
+		0xc0, 0xc8, 0x16, 0xb6, 0x8c, 0x89, 0x89, 0x89, 0x8d, 0x8d, 0x8d, 0x09, 0x06, 0x08, 0xb0, 0x81,
+		0x14, 0x07, 0x07, 0x07, 0x90, 0xc1, 0xc2, 0xc2, 0x42, 0x0c, 0x9b, 0x99, 0xc7, 0x24, 0x86, 0x99,
+		0x99, 0x19, 0xc4, 0x62, 0x66, 0x06, 0x4a, 0x10, 0x64, 0xb3, 0x40, 0xf4, 0x41, 0x00, 0x03, 0x03,
+		0x03, 0x61, 0xb6, 0x54, 0xd6, 0x2e, 0xa0, 0xe7, 0x94, 0x8a, 0x0e, 0x01, 0x7d, 0xa6, 0x56, 0x76,
+		0x0c, 0xe8, 0x39, 0xbd, 0xba, 0x73, 0x40, 0xcf, 0x19, 0x35, 0x5d, 0x32, 0x69, 0xb9, 0x62, 0xd5,
+		0x75, 0xcb, 0xa6, 0xe7, 0x8e, 0x5d, 0xdf, 0x3d, 0x87, 0x09, 0x0f, 0xdc, 0xa6, 0x3d, 0xf3, 0x98,
+		0xf1, 0x82, 0x11, 0x18, 0x0e, 0xc4, 0x9a, 0x0d, 0x66, 0x83, 0x3c, 0x0d, 0xf1, 0x16, 0x91, 0x24,
+		0x00, 0x88, 0xc8, 0x32, 0xde,
+	};
+	const int w = 16, h = 8;
+	std::vector<unsigned char> expected((size_t)w * h * 3);
+	for (size_t i = 0; i < expected.size(); ++i)
+	{
+		const int x = (int)(i / 3 % w), y = (int)(i / 3 / w), c = (int)(i % 3);
+		expected[i] = (unsigned char)((x * 3 + y * 5 + c * 80 + ((x ^ y) & 3)) & 255);
+	}
+	const std::vector<unsigned char> stream(zlib, zlib + sizeof(zlib));
+	check(decodePng(makePng(w, h, stream), w, h, 3, 8, "PNG known answer") == expected, "PNG known answer: pixels");
+
+	std::vector<unsigned char> badAdler = stream;
+	badAdler.back() ^= 1;
+	std::vector<unsigned char> cutFile = makePng(w, h, stream);
+	cutFile.resize(cutFile.size() - 40);
+	const std::pair<std::string, std::vector<unsigned char>> broken[] = {
+		{ "bad Adler-32", makePng(w, h, badAdler) },
+		{ "truncated IDAT", makePng(w, h, std::vector<unsigned char>(stream.begin(), stream.begin() + stream.size() / 2)) },
+		{ "file cut short", cutFile },
+	};
+	const auto filepath = std::filesystem::temp_directory_path() / "imagecodecs_broken.png";
+	for (auto& png : broken)
+	{
+		const std::string what = "PNG with " + png.first;
+		std::vector<unsigned char> pixels(expected.size());
+		int bw, bh, bd, bBitDepth;
+		check(png_encoder::inspect(png.second.data(), png.second.size(), bw, bh, bd, bBitDepth) != 0 ||
+			png_encoder::decode(pixels.data(), png.second.data(), png.second.size()) != 0, what + ": decode fails");
+		std::ofstream(filepath, std::ios::binary).write((const char*)png.second.data(), png.second.size());
+		check(readThrows(filepath), what + ": read throws");
+	}
+	std::filesystem::remove(filepath);
+}
+
+// Pixels of d channels of bitDepth bits as RGBA of outBitDepth bits, as decode() gives them with channels == 4.
+std::vector<unsigned char> toRgba(const std::vector<unsigned char>& pixels, int d, int bitDepth, int outBitDepth)
+{
+	const size_t count = pixels.size() / d / (bitDepth / 8);
+	std::vector<unsigned char> rgba(count * 4 * (outBitDepth / 8));
+	for (size_t i = 0; i < count; ++i)
+	{
+		for (int c = 0; c < 4; ++c)
+		{
+			unsigned v = 0xffff;
+			if (c < 3 || d == 2 || d == 4)
+			{
+				const size_t from = i * d + (c == 3 ? d - 1 : d >= 3 ? c : 0);
+				if (bitDepth == 16)
+				{
+					uint16_t v16;
+					memcpy(&v16, &pixels[from * 2], 2);
+					v = v16;
+				}
+				else
+					v = pixels[from] * 257u;
+			}
+			if (outBitDepth == 16)
+			{
+				const uint16_t v16 = (uint16_t)v;
+				memcpy(&rgba[(i * 4 + c) * 2], &v16, 2);
+			}
+			else
+				rgba[i * 4 + c] = (unsigned char)(v >> 8);
+		}
+	}
+	return rgba;
+}
+
+// saveToFile() stores images as palette, gray or with a color key when that loses nothing. Read as RGBA, they come
+// back as they were.
+void testPngAutoConvert()
+{
+	std::cout << "testing PNG color type conversion" << std::endl;
+	const int w = 64, h = 48;
+	struct Case
+	{
+		std::string name;
+		int d, bitDepth;
+		std::vector<unsigned char> pixels;
+		int fileColorType, fileBitDepth; // as the IHDR chunk gives them
+	};
+	std::vector<Case> cases;
+
+	// A few colors, some of them translucent.
+	std::vector<unsigned char> palette((size_t)w * h * 4);
+	for (size_t i = 0; i < (size_t)w * h; ++i)
+	{
+		const unsigned char k = (unsigned char)(i * 7 % 10);
+		const unsigned char rgba[4] = { (unsigned char)(k * 25), (unsigned char)(255 - k * 20), (unsigned char)(k * k),
+			(unsigned char)(k < 2 ? k * 128 : 255) };
+		memcpy(&palette[i * 4], rgba, 4);
+	}
+	cases.push_back({ "palette", 4, 8, palette, 3, 4 });
+
+	// RGB with equal channels, and 16-bit gray whose values all fit in 8 bits.
+	std::vector<unsigned char> gray((size_t)w * h * 3), gray16((size_t)w * h * 2);
+	for (size_t i = 0; i < (size_t)w * h; ++i)
+	{
+		const unsigned char v = (unsigned char)(i % w * 3 + i / w);
+		memset(&gray[i * 3], v, 3);
+		const uint16_t v16 = (uint16_t)(v * 257);
+		memcpy(&gray16[i * 2], &v16, 2);
+	}
+	cases.push_back({ "gray", 3, 8, gray, 0, 8 });
+	cases.push_back({ "16-bit gray", 1, 16, gray16, 0, 8 });
+
+	// Many colors, where all transparent pixels are the same color that no opaque pixel has.
+	std::vector<unsigned char> colorKey = testPixels(w, h, 4, 8, 1);
+	for (size_t i = 0; i < (size_t)w * h; ++i)
+	{
+		const unsigned char key[4] = { 1, 2, 3, 0 };
+		if (i % 5 == 0)
+			memcpy(&colorKey[i * 4], key, 4);
+		else
+			colorKey[i * 4 + 3] = 255;
+		if (colorKey[i * 4] == 1 && colorKey[i * 4 + 3] == 255)
+			colorKey[i * 4] = 0;
+	}
+	cases.push_back({ "color key", 4, 8, colorKey, 2, 8 });
+	cases.push_back({ "16-bit RGB", 3, 16, testPixels(w, h, 3, 16, 2), 2, 16 });
+
+	const auto filepath = std::filesystem::temp_directory_path() / "imagecodecs_test.png";
+	for (auto& c : cases)
+	{
+		const std::string what = "PNG " + c.name;
+		check(png_encoder::saveToFile(filepath.string(), c.pixels.data(), w, h, c.d, c.bitDepth) == 0, what + ": save");
+		const std::vector<unsigned char> png = readFile(filepath);
+		check(png.size() > 25 && png[25] == c.fileColorType && png[24] == c.fileBitDepth, what + ": color type");
+		const int bitDepth = c.fileBitDepth == 16 ? 16 : 8;
+		check(decodePng(png, w, h, 4, bitDepth, what, 4) == toRgba(c.pixels, c.d, c.bitDepth, bitDepth), what + ": round trip");
+	}
+	std::filesystem::remove(filepath);
+}
+
+// Animations with a frame that repeats, rectangles that change and pixels that turn transparent, read back with
+// AnimationDecoder and AnimatedImage.
+void testApng()
+{
+	std::cout << "testing APNG round trips" << std::endl;
+	const int w = 40, h = 30;
+	const auto filepath = std::filesystem::temp_directory_path() / "imagecodecs_test.apng";
+	for (int d : { 3, 4 })
+	{
+		for (int bitDepth : { 8, 16 })
+		{
+			const std::string what = "APNG of " + std::to_string(d) + " channels of " + std::to_string(bitDepth) + " bits";
+			const size_t pixelBytes = (size_t)d * (bitDepth / 8);
+			std::vector<std::vector<unsigned char>> frames(4, testPixels(w, h, d, bitDepth, 3));
+			for (int y = 5; y < 15; ++y)
+			{
+				for (int x = 10; x < 25; ++x)
+				{
+					unsigned char* px = &frames[1][(y * w + x) * pixelBytes];
+					px[0] ^= 0x55;
+					if (d == 4 && x < 15)
+						memset(px + 3 * (bitDepth / 8), 0, bitDepth / 8);
+				}
+			}
+			frames[2] = frames[1];
+			const int delays[] = { 100, 50, 70, 100 };
+			std::vector<ImageCodecs::AnimationFrame> animation;
+			const unsigned char* pixels[4];
+			for (int i = 0; i < 4; ++i)
+			{
+				animation.push_back({ frames[i].data(), delays[i] });
+				pixels[i] = frames[i].data();
+			}
+			// frame 2 is the same as frame 1, so it only adds to its delay
+			const int shown[] = { 0, 1, 3 };
+			const int shownDelays[] = { 100, 120, 100 };
+
+			check(png_encoder::saveAnimationToFile(filepath.string(), pixels, delays, 4, w, h, d, bitDepth) == 0,
+				what + ": save");
+			const std::vector<unsigned char> png = readFile(filepath);
+			png_encoder::AnimationDecoder decoder;
+			check(decoder.open(png.data(), png.size()) == 0, what + ": open");
+			check(decoder.numFrames() == 3 && decoder.d() == d && decoder.bitDepth() == bitDepth, what + ": frames");
+			for (int i = 0; i < 3 && i < decoder.numFrames(); ++i)
+			{
+				check(decoder.next() == 0 && decoder.frameIndex() == i, what + ": next");
+				check(memcmp(decoder.canvas(), frames[shown[i]].data(), frames[0].size()) == 0 &&
+					decoder.delayMs() == shownDelays[i], what + ": frame " + std::to_string(i));
+			}
+
+			ImageCodecs::AnimatedImage::write(filepath.string(), animation, w, h, d,
+				bitDepth == 16 ? ImageCodecs::Type::USHORT : ImageCodecs::Type::UBYTE);
+			ImageCodecs::AnimatedImage image;
+			image.open(filepath.string());
+			check(image.frameCount() == 3 && image.channels() == d, what + ": AnimatedImage frames");
+			image.seek(1);
+			for (int i = 1; i < 3 && image.next(); ++i)
+			{
+				check(memcmp(image.data(), frames[shown[i]].data(), frames[0].size()) == 0 &&
+					image.delayMs() == shownDelays[i], what + ": AnimatedImage frame " + std::to_string(i));
+			}
+			check(!image.next(), what + ": AnimatedImage end");
+		}
+	}
+	std::filesystem::remove(filepath);
+}
+
+// An animation of a square moving over a still background, with a frame that repeats, comes back from AnimatedImage as
+// it went in: it has fewer colors than the palette, so nothing is dithered. RGB frames store only the rectangle that
+// changed, RGBA frames with transparent pixels of their own the whole canvas.
+void testGifAnimation()
+{
+	std::cout << "testing GIF animation" << std::endl;
+	const int w = 48, h = 40;
+	const auto filepath = std::filesystem::temp_directory_path() / "imagecodecs_test.gif";
+	for (int d : { 3, 4 })
+	{
+		const std::string what = "GIF animation of " + std::to_string(d) + " channels";
+		std::vector<std::vector<unsigned char>> frames(4, std::vector<unsigned char>((size_t)w * h * d));
+		for (int i = 0; i < 4; ++i)
+		{
+			const int square = (i == 2 ? 1 : i) * 9; // frame 2 is the same as frame 1, so it only adds to its delay
+			for (int y = 0; y < h; ++y)
+			{
+				for (int x = 0; x < w; ++x)
+				{
+					unsigned char* px = &frames[i][((size_t)y * w + x) * d];
+					const int color = (x / 6 + y / 5) % 12;
+					px[0] = (unsigned char)(color * 20);
+					px[1] = (unsigned char)(255 - color * 15);
+					px[2] = (unsigned char)(color * 7 % 64);
+					if (x >= square + 4 && x < square + 12 && y >= square && y < square + 8)
+						px[0] = px[1] = px[2] = 255;
+					if (d == 4)
+						px[3] = x < 4 && y < 4 ? 0 : 255;
+				}
+			}
+		}
+		const int delays[] = { 100, 50, 70, 100 };
+		std::vector<ImageCodecs::AnimationFrame> animation;
+		for (int i = 0; i < 4; ++i)
+		{
+			animation.emplace_back();
+			animation.back().pixels = frames[i].data();
+			animation.back().delayMs = delays[i];
+		}
+		const int shown[] = { 0, 1, 3 };
+		const int shownDelays[] = { 100, 120, 100 };
+
+		ImageCodecs::WriteOptions options;
+		options.gifColors = 14; // the 13 colors and the transparent entry, whether that comes from alpha or not
+		ImageCodecs::AnimatedImage::write(filepath.string(), animation, w, h, d, ImageCodecs::Type::UBYTE, 0, options);
+		ImageCodecs::ReadOptions readOptions;
+		readOptions.channels = d == 4 ? 4 : 0;
+		ImageCodecs::AnimatedImage image;
+		image.open(filepath.string(), readOptions);
+		check(image.frameCount() == 3 && image.channels() == d && image.loopCount() == 0, what + ": frames");
+		for (int i = 0; i < 3 && image.next(); ++i)
+		{
+			// transparent pixels only have to stay transparent
+			bool same = image.delayMs() == shownDelays[i];
+			const unsigned char* expected = frames[shown[i]].data();
+			for (size_t p = 0; p < (size_t)w * h; ++p)
+			{
+				if (d == 4 && expected[p * 4 + 3] == 0)
+					same = same && image.data()[p * 4 + 3] == 0;
+				else
+					same = same && memcmp(image.data() + p * d, expected + p * d, d) == 0;
+			}
+			check(same, what + ": frame " + std::to_string(i));
+		}
+		check(!image.next(), what + ": end");
+	}
+	std::filesystem::remove(filepath);
+}
+
+// Random frames of 2 to 256 colors (LZW minimum code sizes 2 to 8) through the cgif encoder and gifdec's decoder, all
+// frames of a palette size in one GIF. The large frames, noise and runs alike, fill the 4096 code dictionary, which
+// the encoder then starts over.
+void testGifLzw()
+{
+	std::cout << "testing GIF LZW round trips" << std::endl;
+	std::mt19937 rng(5);
+	struct Frame
+	{
+		int x, y, w, h;
+		bool runs, interlaced;
+		std::vector<uint8_t> indices;
+	};
+	const Frame layouts[] = {
+		{ 0, 0, 1, 1, false, false }, { 3, 2, 7, 3, false, false }, { 0, 0, 64, 48, false, true },
+		{ 10, 5, 301, 257, false, false }, { 0, 0, 320, 262, true, false },
+	};
+	for (int colors = 2; colors <= 256; colors *= 2)
+	{
+		const std::string what = "GIF of " + std::to_string(colors) + " colors";
+		std::vector<uint8_t> palette(colors * 3), file;
+		for (auto& c : palette)
+			c = (uint8_t)rng();
+		std::vector<Frame> frames(std::begin(layouts), std::end(layouts));
+		for (auto& f : frames)
+		{
+			f.indices.resize((size_t)f.w * f.h);
+			for (size_t i = 0; i < f.indices.size(); ++i)
+				f.indices[i] = (uint8_t)(f.runs && i % 37 != 0 ? f.indices[i - 1] : rng() % colors);
+		}
+
+		gif::CGIFRaw_Config config;
+		memset(&config, 0, sizeof(config));
+		config.pWriteFn = [](void* context, const uint8_t* data, const size_t size) {
+			auto out = (std::vector<uint8_t>*)context;
+			out->insert(out->end(), data, data + size);
+			return 0;
+		};
+		config.pContext = &file;
+		config.pGCT = palette.data();
+		config.sizeGCT = (uint16_t)colors;
+		config.width = 330;
+		config.height = 270;
+		config.attrFlags = CGIF_RAW_ATTR_IS_ANIMATED;
+		gif::CGIFRaw* encoder = gif::cgif_raw_newgif(&config);
+		check(encoder != nullptr, what + ": encoder");
+		if (!encoder)
+			continue;
+		for (auto& f : frames)
+		{
+			gif::CGIFRaw_FrameConfig frameConfig;
+			memset(&frameConfig, 0, sizeof(frameConfig));
+			frameConfig.pImageData = f.indices.data();
+			frameConfig.attrFlags = f.interlaced ? CGIF_RAW_FRAME_ATTR_INTERLACED : 0;
+			frameConfig.left = (uint16_t)f.x;
+			frameConfig.top = (uint16_t)f.y;
+			frameConfig.width = (uint16_t)f.w;
+			frameConfig.height = (uint16_t)f.h;
+			check(gif::cgif_raw_addframe(encoder, &frameConfig) == gif::CGIF_OK, what + ": encode");
+		}
+		check(gif::cgif_raw_close(encoder) == gif::CGIF_OK, what + ": close");
+
+		gif::gd_GIF* decoder = gif::gd_open_gif_memory(file.data(), file.size());
+		check(decoder != nullptr, what + ": open");
+		if (!decoder)
+			continue;
+		for (size_t n = 0; n < frames.size(); ++n)
+		{
+			const Frame& f = frames[n];
+			const std::string frame = what + ", frame " + std::to_string(n);
+			if (gif::gd_decode_frame(decoder) != 1)
+			{
+				check(false, frame + ": decode");
+				break;
+			}
+			check(decoder->fx == f.x && decoder->fy == f.y && decoder->fw == f.w && decoder->fh == f.h, frame + ": rectangle");
+			bool same = true;
+			for (int y = 0; y < f.h && same; ++y)
+				same = memcmp(&decoder->frame[(size_t)(f.y + y) * decoder->width + f.x], &f.indices[(size_t)y * f.w], f.w) == 0;
+			check(same, frame + ": indices");
+		}
+		check(gif::gd_decode_frame(decoder) == 0, what + ": trailer");
+		gif::gd_close_gif(decoder);
+	}
+}
+
+// The bits of a half float as a float.
+float halfToFloat(uint16_t half)
+{
+	const int exponent = (half >> 10) & 31, mantissa = half & 0x3FF;
+	float value;
+	if (exponent == 31)
+		value = mantissa ? NAN : INFINITY;
+	else if (exponent == 0)
+		value = std::ldexp((float)mantissa, -24);
+	else
+		value = std::ldexp((float)(mantissa + 1024), exponent - 25);
+	return half & 0x8000 ? -value : value;
+}
+
+// Blocks of each of the BC1 to BC5 formats with endpoints and indices picked so that every texel they decode to is
+// exact, and the texels worked out from them by hand. BC6H is worked out the same way, to the bits of the halves it
+// gives, and the BC7 blocks are random bits in each of several modes, with the texels another decoder (Pillow's)
+// gives for them.
+void testBcnKnownAnswer()
+{
+	std::cout << "testing block codec known answers" << std::endl;
+	struct KnownBlock
+	{
+		std::string name;
+		bcn::Format format;
+		std::vector<uint8_t> block, texels;
+	};
+	const KnownBlock blocks[] = {
+		// 4 colors: white, black and the two thirds between them.
+		{ "BC1", bcn::Format::BC1,
+			{ 0xff, 0xff, 0x00, 0x00, 0xe4, 0x1b, 0x4e, 0xb1 },
+			{
+				255, 255, 255, 255, 0, 0, 0, 255, 170, 170, 170, 255, 85, 85, 85, 255,
+				85, 85, 85, 255, 170, 170, 170, 255, 0, 0, 0, 255, 255, 255, 255, 255,
+				170, 170, 170, 255, 85, 85, 85, 255, 255, 255, 255, 255, 0, 0, 0, 255,
+				0, 0, 0, 255, 255, 255, 255, 255, 85, 85, 85, 255, 170, 170, 170, 255
+			} },
+		// 3 colors and transparent black: black, (16, 16, 16) and the middle between them.
+		{ "BC1 3 colors", bcn::Format::BC1,
+			{ 0x00, 0x00, 0x82, 0x10, 0xe4, 0x1b, 0x4e, 0xb1 },
+			{
+				0, 0, 0, 255, 16, 16, 16, 255, 8, 8, 8, 255, 0, 0, 0, 0,
+				0, 0, 0, 0, 8, 8, 8, 255, 16, 16, 16, 255, 0, 0, 0, 255,
+				8, 8, 8, 255, 0, 0, 0, 0, 0, 0, 0, 255, 16, 16, 16, 255,
+				16, 16, 16, 255, 0, 0, 0, 255, 0, 0, 0, 0, 8, 8, 8, 255
+			} },
+		// Alpha 0 to 255 in steps of 17, and 4 colors although the endpoints are in 3 color order.
+		{ "BC2", bcn::Format::BC2,
+			{ 0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe, 0x00, 0x00, 0xff, 0xff, 0xe4, 0x1b, 0x4e, 0xb1 },
+			{
+				0, 0, 0, 0, 255, 255, 255, 17, 85, 85, 85, 34, 170, 170, 170, 51,
+				170, 170, 170, 68, 85, 85, 85, 85, 255, 255, 255, 102, 0, 0, 0, 119,
+				85, 85, 85, 136, 170, 170, 170, 153, 0, 0, 0, 170, 255, 255, 255, 187,
+				255, 255, 255, 204, 0, 0, 0, 221, 170, 170, 170, 238, 85, 85, 85, 255
+			} },
+		// Red to blue, and 8 alpha values from 252 down to 0.
+		{ "BC3", bcn::Format::BC3,
+			{ 0xfc, 0x00, 0x88, 0xc6, 0xfa, 0x88, 0xc6, 0xfa, 0x00, 0xf8, 0x1f, 0x00, 0xe4, 0x1b, 0x4e, 0xb1 },
+			{
+				255, 0, 0, 252, 0, 0, 255, 0, 170, 0, 85, 216, 85, 0, 170, 180,
+				85, 0, 170, 144, 170, 0, 85, 108, 0, 0, 255, 72, 255, 0, 0, 36,
+				170, 0, 85, 252, 85, 0, 170, 0, 255, 0, 0, 216, 0, 0, 255, 180,
+				0, 0, 255, 144, 255, 0, 0, 108, 85, 0, 170, 72, 170, 0, 85, 36
+			} },
+		// 6 values from 0 to 250, and 0 and 255.
+		{ "BC4", bcn::Format::BC4,
+			{ 0x00, 0xfa, 0x88, 0xc6, 0xfa, 0x88, 0xc6, 0xfa },
+			{
+				0, 250, 50, 100, 150, 200, 0, 255, 0, 250, 50, 100, 150, 200, 0, 255
+			} },
+		// +1 and -1, given as -128.
+		{ "BC4_SNORM", bcn::Format::BC4_SNORM,
+			{ 0x7f, 0x80, 0x08, 0x82, 0x20, 0x08, 0x82, 0x20 },
+			{
+				255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0
+			} },
+		// Red from 252 down to 0, green from 0 to 250, blue 0.
+		{ "BC5", bcn::Format::BC5,
+			{ 0xfc, 0x00, 0x88, 0xc6, 0xfa, 0x88, 0xc6, 0xfa, 0x00, 0xfa, 0x77, 0x39, 0x05, 0x77, 0x39, 0x05 },
+			{
+				252, 255, 0, 0, 0, 0, 216, 200, 0, 180, 150, 0,
+				144, 100, 0, 108, 50, 0, 72, 250, 0, 36, 0, 0,
+				252, 255, 0, 0, 0, 0, 216, 200, 0, 180, 150, 0,
+				144, 100, 0, 108, 50, 0, 72, 250, 0, 36, 0, 0
+			} },
+		// Red -1 and +1 from the 6 value mode, green +1 and -1.
+		{ "BC5_SNORM", bcn::Format::BC5_SNORM,
+			{ 0x80, 0x7f, 0x3e, 0xe2, 0x23, 0x3e, 0xe2, 0x23, 0x7f, 0x80, 0x08, 0x82, 0x20, 0x08, 0x82, 0x20 },
+			{
+				0, 255, 0, 255, 0, 0, 0, 255, 0, 255, 0, 0,
+				0, 255, 0, 255, 0, 0, 0, 255, 0, 255, 0, 0,
+				0, 255, 0, 255, 0, 0, 0, 255, 0, 255, 0, 0,
+				0, 255, 0, 255, 0, 0, 0, 255, 0, 255, 0, 0
+			} },
+		// Mode 1: two subsets, RGB with a shared P-bit per subset.
+		{ "BC7 mode 1", bcn::Format::BC7,
+			{ 0x3a, 0xb4, 0xe6, 0x52, 0xe4, 0x4d, 0xa7, 0xf2, 0x37, 0x0d, 0x9e, 0x26, 0x0e, 0x27, 0x13, 0x65 },
+			{
+				165, 177, 169, 255, 194, 156, 190, 255, 134, 200, 146, 255, 194, 156, 190, 255,
+				172, 205, 69, 255, 97, 173, 23, 255, 172, 205, 69, 255, 126, 186, 41, 255,
+				143, 192, 51, 255, 157, 199, 60, 255, 97, 173, 23, 255, 126, 186, 41, 255,
+				187, 211, 78, 255, 112, 179, 32, 255, 126, 186, 41, 255, 172, 205, 69, 255
+			} },
+		// Mode 3: two subsets, 7-bit RGB with a P-bit per endpoint.
+		{ "BC7 mode 3", bcn::Format::BC7,
+			{ 0x58, 0xa4, 0xa3, 0xa6, 0xd0, 0x7f, 0x5c, 0x0c, 0x33, 0x2f, 0x8b, 0x12, 0x24, 0x08, 0x3f, 0xd2 },
+			{
+				194, 236, 117, 255, 210, 254, 152, 255, 73, 156, 39, 255, 76, 138, 22, 255,
+				210, 254, 152, 255, 73, 156, 39, 255, 76, 138, 22, 255, 69, 176, 57, 255,
+				162, 198, 46, 255, 66, 194, 74, 255, 73, 156, 39, 255, 76, 138, 22, 255,
+				73, 156, 39, 255, 69, 176, 57, 255, 69, 176, 57, 255, 73, 156, 39, 255
+			} },
+		// Mode 4: alpha rotated into a color channel, with its own 3-bit indices.
+		{ "BC7 mode 4", bcn::Format::BC7,
+			{ 0x30, 0x90, 0x2f, 0x89, 0x11, 0xe8, 0x18, 0x18, 0xf8, 0xc9, 0x9d, 0x5d, 0x5d, 0x98, 0x31, 0x95 },
+			{
+				109, 90, 198, 132, 99, 148, 66, 231, 66, 90, 198, 132, 66, 90, 198, 132,
+				77, 90, 198, 132, 109, 148, 66, 231, 56, 90, 198, 132, 109, 90, 198, 132,
+				130, 90, 198, 132, 99, 148, 66, 231, 66, 148, 66, 231, 130, 148, 66, 231,
+				99, 90, 198, 132, 109, 109, 155, 164, 77, 129, 109, 199, 87, 148, 66, 231
+			} },
+		// Mode 5: alpha rotated into a color channel, and 2-bit indices for both.
+		{ "BC7 mode 5", bcn::Format::BC7,
+			{ 0x60, 0x04, 0xd9, 0x0e, 0x94, 0x5d, 0xe2, 0xe8, 0xf5, 0x4e, 0xe7, 0x81, 0xcc, 0x75, 0xf6, 0x36 },
+			{
+				56, 100, 170, 38, 122, 82, 160, 70, 56, 64, 151, 100, 122, 100, 170, 38,
+				78, 64, 151, 100, 78, 100, 170, 38, 122, 82, 160, 70, 78, 82, 160, 70,
+				100, 64, 151, 100, 78, 118, 179, 8, 122, 64, 151, 100, 122, 64, 151, 100,
+				100, 118, 179, 8, 78, 118, 179, 8, 122, 118, 179, 8, 56, 100, 170, 38
+			} },
+		// Mode 6: one subset, RGBA with 4-bit indices.
+		{ "BC7 mode 6", bcn::Format::BC7,
+			{ 0xc0, 0x50, 0x99, 0x09, 0x5a, 0xa3, 0x00, 0x16, 0x5a, 0x67, 0x03, 0x6f, 0x9b, 0x54, 0x0d, 0x6b },
+			{
+				111, 123, 170, 14, 111, 123, 170, 14, 130, 111, 151, 21, 121, 116, 160, 18,
+				94, 134, 187, 9, 66, 152, 214, 0, 202, 64, 80, 44, 121, 116, 160, 18,
+				166, 87, 116, 32, 147, 100, 134, 26, 102, 129, 178, 12, 111, 123, 170, 14,
+				183, 76, 99, 38, 66, 152, 214, 0, 166, 87, 116, 32, 121, 116, 160, 18
+			} },
+		// Mode 7: two subsets, RGBA.
+		{ "BC7 mode 7", bcn::Format::BC7,
+			{ 0x80, 0x0b, 0xe2, 0x11, 0x24, 0x17, 0x9c, 0x3d, 0xd9, 0xf7, 0x38, 0x17, 0xce, 0x6e, 0x11, 0x8d },
+			{
+				118, 86, 138, 203, 118, 86, 138, 203, 174, 100, 96, 170, 118, 86, 138, 203,
+				227, 113, 56, 138, 118, 86, 138, 203, 227, 113, 56, 138, 174, 100, 96, 170,
+				65, 73, 178, 235, 174, 100, 96, 170, 65, 73, 178, 235, 48, 81, 233, 113,
+				174, 100, 96, 170, 94, 44, 217, 134, 138, 8, 203, 154, 94, 44, 217, 134
+			} },
+		// A reserved mode, which decodes to transparent black.
+		{ "BC7 reserved mode", bcn::Format::BC7,
+			{ 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff },
+			std::vector<uint8_t>(64, 0) },
+	};
+	for (auto& b : blocks)
+	{
+		const std::string what = b.name + " block";
+		check(b.block.size() == bcn::blockBytes(b.format) && b.texels.size() == 16u * bcn::channels(b.format), what + ": size");
+		std::vector<uint8_t> texels(16 * bcn::channels(b.format));
+		check(bcn::decode(b.format, b.block.data(), b.block.size(), 4, 4, texels.data(), 1), what + ": decode");
+		check(texels == b.texels, what + ": texels");
+		check(!bcn::decode(b.format, b.block.data(), b.block.size() - 1, 4, 4, texels.data(), 1), what + ": short data fails");
+	}
+
+	struct KnownHdrBlock
+	{
+		std::string name;
+		bcn::Format format;
+		std::vector<uint8_t> block;
+		std::vector<uint16_t> halves;
+	};
+	const KnownHdrBlock hdrBlocks[] = {
+		// Mode 11 (10-bit endpoints, no deltas) of the unsigned format, with endpoints from 0 to 1023, the largest half,
+		// and all 16 weights between them.
+		{ "BC6H UF16", bcn::Format::BC6H_UF16,
+			{ 0x03, 0x00, 0x00, 0xff, 0xff, 0x9f, 0x8c, 0x00, 0xf0, 0xe1, 0xd2, 0xc3, 0xb4, 0xa5, 0x96, 0x87 },
+			{
+				0x0000, 0x3e0f, 0x7bff, 0x7bff, 0x0c2b, 0x002e, 0x07c0, 0x3af1, 0x7442, 0x743f, 0x0f49, 0x07eb,
+				0x1170, 0x370b, 0x6a96, 0x6a8f, 0x132f, 0x1197, 0x1930, 0x33ed, 0x62d9, 0x62cf, 0x164d, 0x1954,
+				0x20f0, 0x30ce, 0x5b1c, 0x5b0f, 0x196c, 0x2111, 0x28b0, 0x2db0, 0x535f, 0x534f, 0x1c8a, 0x28cf,
+				0x3260, 0x29ca, 0x49b2, 0x499f, 0x2070, 0x327b, 0x3a20, 0x26ac, 0x41f5, 0x41df, 0x238e, 0x3a38
+			} },
+		// Mode 11 of the signed format, whose -512 and 511 saturate to the most negative and the largest half.
+		{ "BC6H SF16", bcn::Format::BC6H_SF16,
+			{ 0x03, 0x40, 0x80, 0x00, 0xf8, 0x8f, 0xda, 0xff, 0xf1, 0xe1, 0xd2, 0xc3, 0xb4, 0xa5, 0x96, 0x87 },
+			{
+				0xfbff, 0x3e1f, 0x0000, 0x7bff, 0xc8c7, 0x805d, 0xec7f, 0x35b0, 0x8005, 0x6c7f, 0xc058, 0x8057,
+				0xd91f, 0x2b26, 0x800c, 0x591f, 0xb5ce, 0x804f, 0xc99f, 0x22b8, 0x8012, 0x499f, 0xad60, 0x8049,
+				0xba20, 0x1a49, 0x8018, 0x3a20, 0xa4f1, 0x8043, 0xaaa0, 0x11db, 0x801e, 0x2aa0, 0x9c83, 0x803e,
+				0x9740, 0x0751, 0x8025, 0x1740, 0x91f9, 0x8037, 0x87c0, 0x811c, 0x802b, 0x07c0, 0x898b, 0x8031
+			} },
+		// A reserved mode, which decodes to black.
+		{ "BC6H reserved mode", bcn::Format::BC6H_UF16,
+			{ 0x13, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff },
+			std::vector<uint16_t>(48, 0) },
+	};
+	for (auto& b : hdrBlocks)
+	{
+		const std::string what = b.name + " block";
+		std::vector<float> texels(16 * 3);
+		check(bcn::decode(b.format, b.block.data(), b.block.size(), 4, 4, (uint8_t*)texels.data(), 1), what + ": decode");
+		bool same = true;
+		for (size_t i = 0; i < texels.size(); ++i)
+			same = same && texels[i] == halfToFloat(b.halves[i]);
+		check(same, what + ": texels");
+	}
+}
+
+// Test images through encode() and back, with a floor on the PSNR of each format and quality a little below what they
+// reach, so that changes which make the endpoint or mode searches worse show up. The sizes leave partly covered blocks
+// on the right and at the bottom.
+void testBcnEncodePsnr()
+{
+	std::cout << "testing block encoder PSNR" << std::endl;
+	struct Floor
+	{
+		std::string name;
+		bcn::Format format;
+		int d;
+		double psnr[3]; // FAST, NORMAL, BEST
+	};
+	const Floor floors[] = {
+		{ "BC1", bcn::Format::BC1, 3, { 31.5, 35.5, 35.5 } },
+		{ "BC3", bcn::Format::BC3, 4, { 32.5, 36.0, 36.5 } },
+		{ "BC7", bcn::Format::BC7, 4, { 36.0, 37.5, 40.0 } },
+		{ "BC7 without alpha", bcn::Format::BC7, 3, { 37.0, 42.0, 42.0 } },
+	};
+	const char* qualities[] = { "FAST", "NORMAL", "BEST" };
+	for (auto& f : floors)
+	{
+		for (int w : { 61, 128 })
+		{
+			const int h = w * 3 / 4;
+			const std::vector<unsigned char> pixels = testPixels(w, h, f.d, 8, 11);
+			for (int q = 0; q < 3; ++q)
+			{
+				const std::string what = f.name + " " + qualities[q] + " at " + std::to_string(w) + " x " + std::to_string(h);
+				std::vector<uint8_t> blocks(bcn::surfaceBytes(f.format, w, h)), decoded((size_t)w * h * 4);
+				if (!bcn::encode(f.format, pixels.data(), w, h, f.d, blocks.data(), (bcn::Quality)q) ||
+					!bcn::decode(f.format, blocks.data(), blocks.size(), w, h, decoded.data()))
+				{
+					check(false, what + ": encode and decode");
+					continue;
+				}
+				double squares = 0;
+				for (size_t i = 0; i < (size_t)w * h; ++i)
+				{
+					for (int c = 0; c < f.d; ++c)
+					{
+						const double e = (double)pixels[i * f.d + c] - decoded[i * 4 + c];
+						squares += e * e;
+					}
+				}
+				const double psnr = 10 * std::log10(255.0 * 255.0 * w * h * f.d / std::max(squares, 1.0));
+				check(psnr >= f.psnr[q], what + ": PSNR " + std::to_string(psnr) + " below " + std::to_string(f.psnr[q]));
+			}
+		}
+	}
+}
+
+// The next mip level of 8-bit pixels of even width and height: each 2x2 block averaged in linear light, with color
+// taken as sRGB and alpha (the last of 2 or 4 channels) as linear.
+std::vector<unsigned char> boxFilter(const unsigned char* pixels, int w, int h, int d)
+{
+	auto toLinear = [](float v) { return v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f); };
+	auto toSrgb = [](float v) { return v <= 0.0031308f ? v * 12.92f : 1.055f * std::pow(v, 1 / 2.4f) - 0.055f; };
+	std::vector<unsigned char> next((size_t)(w / 2) * (h / 2) * d);
+	for (int y = 0; y < h / 2; ++y)
+	{
+		for (int x = 0; x < w / 2; ++x)
+		{
+			for (int c = 0; c < d; ++c)
+			{
+				const bool alpha = (d == 2 || d == 4) && c == d - 1;
+				float sum = 0;
+				for (int i = 0; i < 4; ++i)
+				{
+					const float v = pixels[((size_t)(y * 2 + i / 2) * w + x * 2 + i % 2) * d + c] / 255.f;
+					sum += alpha ? v : toLinear(v);
+				}
+				const float v = alpha ? sum / 4 : toSrgb(sum / 4);
+				next[((size_t)y * (w / 2) + x) * d + c] = (unsigned char)std::lround(v * 255);
+			}
+		}
+	}
+	return next;
+}
+
+// A DDS file written with BOX mipmaps holds at each level read back the level above it box-filtered, give or take
+// one for rounding.
+void testDdsMipmaps()
+{
+	std::cout << "testing DDS mipmaps" << std::endl;
+	const int w = 64, h = 32;
+	const auto filepath = std::filesystem::temp_directory_path() / "imagecodecs_test.dds";
+	for (int d : { 3, 4 })
+	{
+		const std::string what = "DDS mipmaps of " + std::to_string(d) + " channels";
+		std::vector<unsigned char> expected = testPixels(w, h, d, 8, 40 + d);
+		unsigned char* pixels = new unsigned char[expected.size()];
+		memcpy(pixels, expected.data(), expected.size());
+		ImageCodecs::Image image;
+		image.load(pixels, w, h, d);
+		ImageCodecs::WriteOptions options;
+		options.ddsMipmaps = ImageCodecs::MipFilter::BOX;
+		image.write(filepath.string(), options);
+
+		for (int level = 0, lw = w, lh = h; lh > 1; ++level, lw /= 2, lh /= 2)
+		{
+			ImageCodecs::ReadOptions readOptions;
+			readOptions.ddsMipLevel = level;
+			ImageCodecs::Image mip;
+			mip.read(filepath.string(), readOptions);
+			const std::string mipWhat = what + ", level " + std::to_string(level);
+			const bool layout = mip.cols() == lw && mip.rows() == lh && mip.channels() == d &&
+				mip.type() == ImageCodecs::Type::UBYTE;
+			check(layout, mipWhat + ": size and layout");
+			if (!layout)
+				break;
+			bool close = true;
+			for (size_t i = 0; i < expected.size(); ++i)
+				close = close && std::abs((*mip.data())[i] - expected[i]) <= (level ? 1 : 0);
+			check(close, mipWhat + ": pixels");
+			expected = boxFilter(*mip.data(), lw, lh, d);
+		}
+	}
+	std::filesystem::remove(filepath);
+}
+
+// Cubemaps, volumes and texture arrays written to DDS files come back with every layer as it was.
+void testDdsLayers()
+{
+	std::cout << "testing DDS cubemaps, volumes and arrays" << std::endl;
+	const int w = 16, h = 16; // cubemap faces are square
+	const auto filepath = std::filesystem::temp_directory_path() / "imagecodecs_test.dds";
+	struct Case
+	{
+		std::string name;
+		ImageCodecs::Layout layout;
+		int layers, d;
+		ImageCodecs::MipFilter mipmaps;
+	};
+	const Case cases[] = {
+		{ "cubemap", ImageCodecs::Layout::CUBEMAP, 6, 4, ImageCodecs::MipFilter::NONE },
+		{ "RGB cubemap", ImageCodecs::Layout::CUBEMAP, 6, 3, ImageCodecs::MipFilter::NONE },
+		{ "cubemap with mipmaps", ImageCodecs::Layout::CUBEMAP, 6, 4, ImageCodecs::MipFilter::BOX },
+		{ "volume", ImageCodecs::Layout::VOLUME, 5, 4, ImageCodecs::MipFilter::NONE },
+		{ "array", ImageCodecs::Layout::ARRAY, 3, 4, ImageCodecs::MipFilter::NONE },
+		{ "array with mipmaps", ImageCodecs::Layout::ARRAY, 3, 4, ImageCodecs::MipFilter::BOX },
+	};
+	for (auto& c : cases)
+	{
+		const std::string what = "DDS " + c.name;
+		const std::vector<unsigned char> expected = testPixels(w, h * c.layers, c.d, 8, 50 + c.layers);
+		unsigned char* pixels = new unsigned char[expected.size()];
+		memcpy(pixels, expected.data(), expected.size());
+		ImageCodecs::Image image;
+		image.load(pixels, w, h, c.d, c.layers, c.layout);
+		ImageCodecs::WriteOptions options;
+		options.ddsMipmaps = c.mipmaps;
+		image.write(filepath.string(), options);
+
+		ImageCodecs::Image copy;
+		copy.read(filepath.string());
+		check(copy.cols() == w && copy.rows() == h && copy.channels() == c.d && copy.layers() == c.layers &&
+			copy.layout() == c.layout && copy.totalBytes() == expected.size(), what + ": size and layout");
+		check(copy.totalBytes() == expected.size() && memcmp(*copy.data(), expected.data(), expected.size()) == 0,
+			what + ": pixels");
+	}
+	std::filesystem::remove(filepath);
+}
+
+// Flipping BC1 and BC3 surfaces by whole blocks gives what decoding them and flipping the pixels gives; an odd number
+// of block rows leaves the middle row to flip within itself, and surfaces less high than a block flip the rows they
+// have inside each block. BC7 blocks and heights that end in a partial row of blocks are refused and left as they
+// were.
+void testDdsFlipBlocks()
+{
+	std::cout << "testing DDS block flips" << std::endl;
+	const int w = 24;
+	const bcn::Format formats[] = { bcn::Format::BC1, bcn::Format::BC3, bcn::Format::BC7 };
+	const char* names[] = { "BC1", "BC3", "BC7" };
+	for (int h : { 20, 1, 2, 3 })
+	{
+		const std::vector<unsigned char> pixels = testPixels(w, h, 4, 8, 60);
+		for (int f = 0; f < 3; ++f)
+		{
+			const std::string what = std::string(names[f]) + " block flip of " + std::to_string(h) + " rows";
+			std::vector<uint8_t> blocks(bcn::surfaceBytes(formats[f], w, h));
+			check(bcn::encode(formats[f], pixels.data(), w, h, 4, blocks.data()), what + ": encode");
+			std::vector<uint8_t> flipped = blocks;
+			const bool flips = nv_dds::CDDSImage::flip_blocks(formats[f], flipped.data(), w, h);
+			if (formats[f] == bcn::Format::BC7)
+			{
+				check(!flips && flipped == blocks, what + ": refused");
+				continue;
+			}
+			check(flips, what + ": flips");
+			const size_t rowBytes = (size_t)w * bcn::channels(formats[f]);
+			std::vector<uint8_t> decoded(rowBytes * h), decodedFlipped(rowBytes * h);
+			bcn::decode(formats[f], blocks.data(), blocks.size(), w, h, decoded.data());
+			bcn::decode(formats[f], flipped.data(), flipped.size(), w, h, decodedFlipped.data());
+			bool same = true;
+			for (int y = 0; y < h; ++y)
+				same = same && memcmp(&decoded[y * rowBytes], &decodedFlipped[(h - 1 - y) * rowBytes], rowBytes) == 0;
+			check(same, what + ": pixels");
+		}
+	}
+	std::vector<uint8_t> blocks(bcn::surfaceBytes(bcn::Format::BC1, w, 6)), unchanged = blocks;
+	check(!nv_dds::CDDSImage::flip_blocks(bcn::Format::BC1, blocks.data(), w, 6) && blocks == unchanged,
+		"BC1 block flip of 6 rows: refused");
+}
+
+// Bottom-up images written to BMP and TGA files keep their rows in that order, and are read back that way; row() gives
+// the image the right way up either way. BMP is only written as RGB, and the TGA writer does not swap R and B as the
+// reader does, so the pixels here have the same R and B. TIFF files are always written and read top to bottom.
+void testBottomUp()
+{
+	std::cout << "testing bottom-up images" << std::endl;
+	const int w = 21, h = 13;
+	const std::pair<const char*, int> cases[] = { { ".bmp", 3 }, { ".tga", 3 }, { ".tga", 4 } };
+	for (auto& c : cases)
+	{
+		const int d = c.second;
+		const std::string what = std::string(c.first) + " of " + std::to_string(d) + " channels";
+		const auto filepath = std::filesystem::temp_directory_path() / (std::string("imagecodecs_test") + c.first);
+		const auto copyPath = std::filesystem::temp_directory_path() / (std::string("imagecodecs_copy") + c.first);
+		std::vector<unsigned char> expected = testPixels(w, h, d, 8, 70 + d);
+		for (size_t i = 0; i < expected.size(); i += d)
+			expected[i + 2] = expected[i];
+		unsigned char* pixels = new unsigned char[expected.size()];
+		memcpy(pixels, expected.data(), expected.size());
+		ImageCodecs::Image image;
+		image.load(pixels, w, h, d);
+		image.setBottomUp(true);
+		image.write(filepath.string());
+
+		ImageCodecs::Image copy;
+		copy.read(filepath.string());
+		auto sameRows = [&](ImageCodecs::Image& img) {
+			bool same = img.cols() == w && img.rows() == h && img.channels() == d;
+			for (int y = 0; same && y < h; ++y)
+				same = memcmp(img.row(y), &expected[(size_t)y * w * d], (size_t)w * d) == 0;
+			return same;
+		};
+		check(copy.bottomUp() && sameRows(copy), what + ": read");
+		copy.write(copyPath.string());
+		check(readFile(copyPath) == readFile(filepath), what + ": written as read");
+		copy.setBottomUp(false);
+		check(!copy.bottomUp() && sameRows(copy) && memcmp(*copy.data(), expected.data(), expected.size()) == 0,
+			what + ": top-down");
+		std::filesystem::remove(filepath);
+		std::filesystem::remove(copyPath);
+	}
+
+	const auto filepath = std::filesystem::temp_directory_path() / "imagecodecs_test.tif";
+	std::vector<unsigned char> expected = testPixels(w, h, 3, 8, 76);
+	unsigned char* pixels = new unsigned char[expected.size()];
+	memcpy(pixels, expected.data(), expected.size());
+	ImageCodecs::Image image;
+	image.load(pixels, w, h, 3);
+	image.setBottomUp(true);
+	image.write(filepath.string());
+	check(!image.bottomUp(), ".tif: flipped for writing");
+	ImageCodecs::Image copy;
+	copy.read(filepath.string());
+	check(copy.cols() == w && copy.rows() == h && copy.channels() == 3 && !copy.bottomUp() &&
+		memcmp(*copy.data(), expected.data(), expected.size()) == 0, ".tif: read top-down");
+	std::filesystem::remove(filepath);
+}
+
+// EXR files of 1, 3 and 4 float channels come back from Image as RGBA floats: gray fills all four, and alpha is 1
+// without an A channel. They match what tinyexr's own LoadEXR() gives, and survive Image writing them again.
+void testExrRoundTrip()
+{
+	std::cout << "testing EXR round trips" << std::endl;
+	const int w = 37, h = 70; // several ZIP chunks of 16 rows, the last one partly filled
+	const auto filepath = std::filesystem::temp_directory_path() / "imagecodecs_test.exr";
+	const auto copyPath = std::filesystem::temp_directory_path() / "imagecodecs_copy.exr";
+	std::mt19937 rng(80);
+	for (int d : { 1, 3, 4 })
+	{
+		const std::string what = "EXR of " + std::to_string(d) + " channels";
+		std::vector<float> values((size_t)w * h * d);
+		for (auto& v : values)
+			v = (float)(rng() % 20000) / 1000.f - 5;
+		check(SaveEXR(values.data(), w, h, d, 0, filepath.string().c_str(), nullptr) == TINYEXR_SUCCESS, what + ": save");
+		std::vector<float> expected((size_t)w * h * 4);
+		for (size_t i = 0; i < expected.size(); ++i)
+		{
+			const size_t p = i / 4;
+			const int k = (int)(i % 4);
+			expected[i] = d == 1 ? values[p] : k < d ? values[p * d + k] : 1.0f;
+		}
+
+		ImageCodecs::Image image;
+		image.read(filepath.string());
+		const bool layout = image.cols() == w && image.rows() == h && image.channels() == 4 &&
+			image.type() == ImageCodecs::Type::FLOAT;
+		check(layout, what + ": size and layout");
+		if (!layout)
+			continue;
+		check(memcmp(*image.data(), expected.data(), expected.size() * 4) == 0, what + ": pixels");
+		float* rgba = nullptr;
+		int rw = 0, rh = 0;
+		check(LoadEXR(&rgba, &rw, &rh, filepath.string().c_str(), nullptr) == TINYEXR_SUCCESS && rw == w && rh == h &&
+			memcmp(rgba, *image.data(), expected.size() * 4) == 0, what + ": same as LoadEXR");
+		free(rgba);
+
+		image.write(copyPath.string());
+		ImageCodecs::Image copy;
+		copy.read(copyPath.string());
+		check(copy.cols() == w && copy.rows() == h && copy.channels() == 4 &&
+			memcmp(*copy.data(), expected.data(), expected.size() * 4) == 0, what + ": written again");
+	}
+	std::filesystem::remove(filepath);
+	std::filesystem::remove(copyPath);
+}
+
+// EXR chunks compressed on one thread and on several make the same file, which decodes the same on either.
+void testExrThreads()
+{
+	std::cout << "testing EXR on the thread pool" << std::endl;
+	const int w = 64, h = 200, d = 4;
+	const auto filepath = std::filesystem::temp_directory_path() / "imagecodecs_test.exr";
+	std::mt19937 rng(90);
+	std::vector<float> values((size_t)w * h * d);
+	for (size_t i = 0; i < values.size(); ++i)
+		values[i] = (float)(i / d % w) / w + (float)(rng() % 100) / 1000.f;
+	check(SaveEXR(values.data(), w, h, d, 0, filepath.string().c_str(), nullptr) == TINYEXR_SUCCESS, "EXR threads: save");
+
+	const unsigned threads = ImageCodecs::threadCount();
+	std::vector<unsigned char> files[2], decoded[2];
+	for (int t = 0; t < 2; ++t)
+	{
+		ImageCodecs::setThreadCount(t ? 4 : 1);
+		ImageCodecs::Image image;
+		image.read(filepath.string());
+		decoded[t].assign(*image.data(), *image.data() + (size_t)w * h * 4 * sizeof(float));
+		const auto copyPath = std::filesystem::temp_directory_path() / "imagecodecs_copy.exr";
+		image.write(copyPath.string());
+		files[t] = readFile(copyPath);
+		std::filesystem::remove(copyPath);
+	}
+	ImageCodecs::setThreadCount(threads);
+	check(decoded[0] == decoded[1], "EXR threads: decoded the same");
+	check(!files[0].empty() && files[0] == files[1], "EXR threads: same file");
+	std::filesystem::remove(filepath);
+}
+
+
+
+int main(int argc, char** argv)
+{
+	if (!std::filesystem::exists("test"))
+	{
+		std::filesystem::create_directory("test");
+	}
+
+	testPngThreads();
+	testPngLevels();
+	testPngFilters();
+	testPngStreamEncoder();
+	testPng16Bit();
+#ifndef IMAGECODECS_NO_LIBPNG
+	testPngStreamDecoder();
+#endif
+	testPngKnownAnswer();
+	testPngAutoConvert();
+	testApng();
+	testGifAnimation();
+	testGifLzw();
+	testBcnKnownAnswer();
+	testBcnEncodePsnr();
+	testDdsMipmaps();
+	testDdsLayers();
+	testDdsFlipBlocks();
+	testBottomUp();
+	testExrRoundTrip();
+	testExrThreads();
+
+	for (auto& testFile : std::filesystem::recursive_directory_iterator("data"))
+	{
+		try
+		{
+			ImageCodecs::Image img;
+
+			// Test .read()
+			std::cout << "reading from disk: " << testFile.path().string() << std::endl;
+			img.read(testFile.path().string());
+
+			// Display read pixels.
+			if (!img.empty())
+			{
+#ifdef _DISPLAY_RESULTS
+				displayResult(testFile.path().string(), img);
+#endif
+			}
+
+			// Test .write()
+			auto parent = testFile.path().parent_path();
+			auto newName = testFile.path().filename().string();
+			auto ext = testFile.path().extension().string();
+			newName = "test\\" + newName.substr(0, newName.rfind(".")) + "_icdTest" + ext;
+			img.write(newName);
+		}
+		catch (std::exception& e)
+		{
+			std::cerr << e.what() << std::endl;
+		}
+	}
+
+
+	// Now try to 'read' all the newly written test files.
+	for (auto& testFile : std::filesystem::recursive_directory_iterator("test"))
+	{
+		try
+		{
+			ImageCodecs::Image img;
+
+			// Test .read()
+			std::cout << "reading from disk: " << testFile.path().string() << std::endl;
+			img.read(testFile.path().string());
+
+			// Display read pixels.
+			if (!img.empty())
+			{
+#ifdef _DISPLAY_RESULTS
+				displayResult(testFile.path().string(), img);
+#endif
+			}
+
+
+			// Test .write()
+			auto parent = testFile.path().parent_path();
+			auto newName = testFile.path().filename().string();
+			auto ext = testFile.path().extension().string();
+			newName = "test2\\" + newName.substr(0, newName.rfind(".")) + "_icdTest" + ext;
+			img.write(newName);
+		}
+		catch (std::exception& e)
+		{
+			std::cerr << e.what() << std::endl;
+		}
+	}
+
+	return failures ? EXIT_FAILURE : EXIT_SUCCESS;
 }
\ No newline at end of file
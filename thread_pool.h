@@ -0,0 +1,174 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace ImageCodecs
+{
+	// Fixed-size pool of worker threads shared by the codecs, so that no encoder/decoder has to spawn its own threads per call.
+	class ThreadPool
+	{
+		std::vector<std::thread> workers_;
+		std::queue<std::function<void()>> tasks_;
+		std::mutex mutex_;
+		std::condition_variable cv_;
+		bool stopping_ = false;
+
+		void workerLoop()
+		{
+			for (;;)
+			{
+				std::function<void()> task;
+				{
+					std::unique_lock<std::mutex> lock(mutex_);
+					cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+					if (stopping_ && tasks_.empty())
+						return;
+					task = std::move(tasks_.front());
+					tasks_.pop();
+				}
+				task();
+			}
+		}
+
+		void start(unsigned numThreads)
+		{
+			if (numThreads == 0)
+				numThreads = 1;
+			// The thread calling parallelFor() always takes part in the work, so one worker less is needed.
+			for (unsigned i = 1; i < numThreads; ++i)
+				workers_.emplace_back(&ThreadPool::workerLoop, this);
+		}
+
+		// Lets the workers finish the tasks already submitted, then joins them.
+		void stop()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				stopping_ = true;
+			}
+			cv_.notify_all();
+			for (auto& t : workers_)
+				t.join();
+			workers_.clear();
+			stopping_ = false;
+		}
+
+	public:
+		explicit ThreadPool(unsigned numThreads = std::thread::hardware_concurrency())
+		{
+			start(numThreads);
+		}
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		~ThreadPool()
+		{
+			stop();
+		}
+
+		// Restarts the pool with numThreads threads, including the calling thread. Nothing may use the pool
+		// while it is resized.
+		void resize(unsigned numThreads)
+		{
+			stop();
+			start(numThreads);
+		}
+
+		// Number of threads that can work on a parallelFor() at once, including the calling thread.
+		inline unsigned size() const { return (unsigned)workers_.size() + 1; }
+
+		void submit(std::function<void()> task)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				tasks_.push(std::move(task));
+			}
+			cv_.notify_one();
+		}
+
+		// Calls fn(i) for every i in [begin, end), handing out indices dynamically so uneven work balances itself.
+		// The calling thread works too and the call only waits for the indices themselves to finish, which makes
+		// nested parallelFor() calls from inside a task safe. The first exception thrown by fn is rethrown here.
+		// maxThreads limits the number of threads used (0 == whole pool).
+		void parallelFor(size_t begin, size_t end, const std::function<void(size_t)>& fn, unsigned maxThreads = 0)
+		{
+			if (end <= begin)
+				return;
+			size_t count = end - begin;
+			unsigned numThreads = size();
+			if (maxThreads != 0 && maxThreads < numThreads)
+				numThreads = maxThreads;
+			if (count < numThreads)
+				numThreads = (unsigned)count;
+			if (numThreads <= 1)
+			{
+				for (size_t i = begin; i < end; ++i)
+					fn(i);
+				return;
+			}
+
+			struct Shared
+			{
+				std::function<void(size_t)> fn;
+				size_t begin = 0;
+				size_t end = 0;
+				std::atomic<size_t> next{ 0 };
+				std::atomic<size_t> done{ 0 };
+				std::mutex mutex;
+				std::condition_variable cv;
+				std::exception_ptr error;
+			};
+			auto shared = std::make_shared<Shared>();
+			shared->fn = fn;
+			shared->begin = begin;
+			shared->end = end;
+			shared->next = begin;
+
+			auto work = [shared]()
+			{
+				size_t i;
+				while ((i = shared->next.fetch_add(1)) < shared->end)
+				{
+					try
+					{
+						shared->fn(i);
+					}
+					catch (...)
+					{
+						std::lock_guard<std::mutex> lock(shared->mutex);
+						if (!shared->error)
+							shared->error = std::current_exception();
+					}
+					if (shared->done.fetch_add(1) + 1 == shared->end - shared->begin)
+					{
+						std::lock_guard<std::mutex> lock(shared->mutex);
+						shared->cv.notify_all();
+					}
+				}
+			};
+
+			for (unsigned t = 1; t < numThreads; ++t)
+				submit(work);
+			work();
+
+			std::unique_lock<std::mutex> lock(shared->mutex);
+			shared->cv.wait(lock, [&] { return shared->done.load() == count; });
+			if (shared->error)
+				std::rethrow_exception(shared->error);
+		}
+
+		// Pool shared by the whole library.
+		static ThreadPool& global()
+		{
+			static ThreadPool pool;
+			return pool;
+		}
+	};
+}
\ No newline at end of file